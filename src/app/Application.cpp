@@ -122,6 +122,8 @@ void Application::setupThemeSizes(ImGuiStyle& style) { style.WindowRounding = 3.
 
 void Application::renderMenuBar() {}
 
+void Application::renderDebugMenu() {}
+
 void Application::renderMain() {
     ImGui::TextUnformatted("Hello, world!");
     ImGui::TextUnformatted("Placeholder main window text");
@@ -336,6 +338,7 @@ void Application::mainLoopBody() {
                 if (ImGui::BeginMenu("Debug")) {
                     ImGui::MenuItem("Show FPS", nullptr, &m_doShowFps);
                     ImGui::MenuItem("Show ImGui metrics", nullptr, &m_doShowMetrics);
+                    renderDebugMenu();
                     ImGui::EndMenu();
                 }
             }
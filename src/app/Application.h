@@ -44,6 +44,9 @@ class Application {
     virtual void renderMain();
     virtual void renderOther();
 
+    // Extra items at the end of the debug menu.
+    virtual void renderDebugMenu();
+
    private:
     bool initGLFW();
     bool loadGLFunctions();
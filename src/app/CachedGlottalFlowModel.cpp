@@ -1,34 +1,24 @@
 #include "CachedGlottalFlowModel.h"
 
-#include <iostream>
-
-CachedGlottalFlowModel::CachedGlottalFlowModel() : m_periodLength(0), m_isDirty(true) {}
-
-Scalar CachedGlottalFlowModel::get(const int i) {
-    if (i < 0 || i >= m_periodLength) {
-        std::cerr << "Missing GFM cache value" << std::endl;
-        return 0;  // silently cache miss
+CachedGlottalFlowModel::CachedGlottalFlowModel(const int tableSize)
+    : m_tableSize(tableSize),
+      m_times(tableSize + 1),
+      m_cachedValues(tableSize + 1, 0),
+      m_isDirty(true) {
+    // Time-reversed, with one guard point at the end so that interpolation never
+    // needs to wrap around.
+    for (int i = 0; i <= m_tableSize; ++i) {
+        m_times[i] = 1 - Scalar(i) / Scalar(m_tableSize);
     }
-    return m_cachedValues[i];
 }
 
-void CachedGlottalFlowModel::setPeriodLength(const int periodLength) {
-    if (m_periodLength != periodLength) {
-        m_periodLength = periodLength;
-        m_isDirty = true;
-    }
-}
+int CachedGlottalFlowModel::tableSize() const { return m_tableSize; }
 
 void CachedGlottalFlowModel::markModelChanged() { m_isDirty = true; }
 
 bool CachedGlottalFlowModel::isDirty() const { return m_isDirty; }
 
-void CachedGlottalFlowModel::updateCache(GlottalFlowModel* model) {
-    m_cachedValues.resize(m_periodLength);
-    for (int i = 0; i < m_periodLength; ++i) {
-        // Time-reverse it.
-        m_cachedValues[i] =
-            model->evaluate(Scalar(m_periodLength - 1 - i) / Scalar(m_periodLength - 1));
-    }
+void CachedGlottalFlowModel::updateCache(const GlottalFlowModel* model) {
+    model->evaluateBlock(m_times.data(), m_cachedValues.data(), m_tableSize + 1);
     m_isDirty = false;
-}
\ No newline at end of file
+}
@@ -1,25 +1,40 @@
 #ifndef SOURCEMODEL__CACHED_GLOTTAL_FLOW_MODEL_H
 #define SOURCEMODEL__CACHED_GLOTTAL_FLOW_MODEL_H
 
+#include <algorithm>
+#include <vector>
+
 #include "GlottalFlowModel.h"
 
+// One period of the model sampled at a fixed resolution, independent of f0.
+// Read with a phase in [0, 1) so that pitch changes never require recaching.
 class CachedGlottalFlowModel {
    public:
-    CachedGlottalFlowModel();
+    static constexpr int kDefaultTableSize = 4096;
+
+    CachedGlottalFlowModel(int tableSize = kDefaultTableSize);
+
+    int tableSize() const;
 
-    Scalar get(int i);
+    // Linearly interpolated, the table is much finer than any audio-rate period.
+    Scalar get(const Scalar phase) const {
+        const Scalar x = phase * m_tableSize;
+        const int    i = std::clamp(int(x), 0, m_tableSize - 1);
+        const Scalar frac = x - i;
+        return m_cachedValues[i] + frac * (m_cachedValues[i + 1] - m_cachedValues[i]);
+    }
 
-    void setPeriodLength(int periodLength);
     void markModelChanged();
 
     bool isDirty() const;
 
-    void updateCache(GlottalFlowModel* model);
+    void updateCache(const GlottalFlowModel* model);
 
    private:
-    int                 m_periodLength;
+    int                 m_tableSize;
+    std::vector<Scalar> m_times;
     std::vector<Scalar> m_cachedValues;
     bool                m_isDirty;
 };
 
-#endif  //  SOURCEMODEL__CACHED_GLOTTAL_FLOW_MODEL_H
\ No newline at end of file
+#endif  //  SOURCEMODEL__CACHED_GLOTTAL_FLOW_MODEL_H
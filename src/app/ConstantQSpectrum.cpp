@@ -0,0 +1,182 @@
+#include "ConstantQSpectrum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "audio/BufferedGenerator.h"
+
+namespace {
+// Level of bands that haven't had a coefficient yet, finite so it interpolates.
+constexpr Scalar kFloorDb = -300;
+}  // namespace
+
+ConstantQSpectrum::ConstantQSpectrum(BufferedGenerator* generator,
+                                     const int bandsPerOctave, const Scalar minFrequency)
+    : m_generator(generator),
+      m_bandsPerOctave(bandsPerOctave),
+      m_minFrequency(minFrequency),
+      m_fs(48000),
+      m_scale(FrequencyScale_Mel),
+      m_firstBand(0),
+      m_lastBand(0),
+      m_support(0),
+      m_analyzed(std::numeric_limits<int64_t>::min()),
+      m_completed(0) {
+    constructAnalyzer();
+}
+
+ConstantQSpectrum::~ConstantQSpectrum() = default;
+
+void ConstantQSpectrum::setSampleRate(const Scalar fs) {
+    if (!fuzzyEquals(m_fs, fs)) {
+        m_fs = fs;
+        constructAnalyzer();
+    }
+}
+
+FrequencyScale ConstantQSpectrum::frequencyScale() const { return m_scale; }
+
+void ConstantQSpectrum::setFrequencyScale(const FrequencyScale scale) {
+    if (m_scale != scale) {
+        m_scale = scale;
+        constructDisplay();
+    }
+}
+
+void ConstantQSpectrum::update() {
+    const int length = m_generator->bufferLength();
+    m_buffer.resize(length);
+
+    const int64_t end = m_generator->copyBufferTo(m_buffer);
+    const int64_t start = end - length;
+
+    if (m_analyzed < start || m_analyzed > end) {
+        restart(start);
+    }
+    if (m_analyzed == end) {
+        return;
+    }
+
+    m_analyzer->analyze(&m_buffer[m_analyzed - start], m_analyzed, end, *m_coefs);
+    m_analyzed = end;
+
+    // Coefficients are final once the analysis has gone past their support.
+    const int64_t complete = end - m_support;
+    if (complete <= m_completed) {
+        return;
+    }
+
+    std::fill(m_bandPower.begin(), m_bandPower.end(), 0);
+    std::fill(m_bandCoefCount.begin(), m_bandCoefCount.end(), 0);
+
+    gaborator::process(
+        [this](const int band, const int64_t, std::complex<Scalar>& coef) {
+            const int j = m_bandPosition[band - m_firstBand];
+            m_bandPower[j] += std::norm(coef);
+            m_bandCoefCount[j]++;
+        },
+        m_firstBand, m_lastBand, m_completed, complete, *m_coefs);
+
+    m_completed = complete;
+    gaborator::forget_before(*m_analyzer, *m_coefs, complete);
+
+    // Low bands have sparse coefficients, keep their level until they have a new one.
+    const int bandCount = m_bandFreqs.size();
+    for (int j = 0; j < bandCount; ++j) {
+        if (m_bandCoefCount[j] > 0) {
+            const Scalar rms = std::sqrt(m_bandPower[j] / m_bandCoefCount[j]);
+            m_bandLevels[j] = std::max(10 * std::log10(rms), kFloorDb);
+        }
+    }
+
+    for (int i = 0; i < kDisplayPoints; ++i) {
+        const int    j = m_displayBand[i];
+        const Scalar w = m_displayWeight[i];
+        m_spls[i] = (1 - w) * m_bandLevels[j] + w * m_bandLevels[j + 1];
+    }
+}
+
+const Scalar* ConstantQSpectrum::frequencies() const { return m_freqs.data(); }
+
+const Scalar* ConstantQSpectrum::magnitudesDb() const { return m_spls.data(); }
+
+int ConstantQSpectrum::binCount() const { return m_freqs.size(); }
+
+int ConstantQSpectrum::bandCount() const { return m_bandFreqs.size(); }
+
+Scalar ConstantQSpectrum::latency() const { return m_support / m_fs; }
+
+void ConstantQSpectrum::constructAnalyzer() {
+    // Frequencies are relative to the sample rate, the reference is A4.
+    const gaborator::parameters params(m_bandsPerOctave, m_minFrequency / m_fs,
+                                       440 / m_fs);
+    m_analyzer = std::make_unique<Analyzer>(params);
+
+    m_firstBand = m_analyzer->bandpass_bands_begin();
+    m_lastBand = m_analyzer->bandpass_bands_end();
+    m_support = std::ceil(m_analyzer->analysis_support());
+
+    const int bandCount = m_lastBand - m_firstBand;
+
+    // Sort the bands by frequency, whatever order gaborator numbers them in.
+    std::vector<int> order(bandCount);
+    std::iota(order.begin(), order.end(), 0);
+    const auto bandFrequency = [this](const int k) {
+        return m_analyzer->band_ff(m_firstBand + k);
+    };
+    std::sort(order.begin(), order.end(), [&](const int a, const int b) {
+        return bandFrequency(a) < bandFrequency(b);
+    });
+
+    m_bandPosition.resize(bandCount);
+    m_bandFreqs.resize(bandCount);
+    for (int j = 0; j < bandCount; ++j) {
+        m_bandPosition[order[j]] = j;
+        m_bandFreqs[j] = bandFrequency(order[j]) * m_fs;
+    }
+    m_bandPower.assign(bandCount, 0);
+    m_bandCoefCount.assign(bandCount, 0);
+    m_bandLevels.assign(bandCount, kFloorDb);
+
+    m_analyzed = std::numeric_limits<int64_t>::min();
+
+    constructDisplay();
+}
+
+void ConstantQSpectrum::constructDisplay() {
+    const double lo = FrequencyScale_TransformFwd(m_bandFreqs.front(), &m_scale);
+    const double hi = FrequencyScale_TransformFwd(m_bandFreqs.back(), &m_scale);
+
+    m_freqs.resize(kDisplayPoints);
+    m_spls.assign(kDisplayPoints, -std::numeric_limits<Scalar>::infinity());
+    m_displayBand.resize(kDisplayPoints);
+    m_displayWeight.resize(kDisplayPoints);
+
+    const int lastBand = m_bandFreqs.size() - 1;
+
+    for (int i = 0; i < kDisplayPoints; ++i) {
+        const double position = lo + (hi - lo) * i / (kDisplayPoints - 1);
+        const Scalar f = std::clamp<Scalar>(
+            FrequencyScale_TransformInv(position, &m_scale), m_bandFreqs.front(),
+            m_bandFreqs.back());
+
+        // Bands j and j + 1 around f, interpolated in log frequency like the bands.
+        const auto it = std::upper_bound(m_bandFreqs.begin(), m_bandFreqs.end(), f);
+        const int  j = std::clamp<int>(std::distance(m_bandFreqs.begin(), it) - 1, 0,
+                                       lastBand - 1);
+
+        m_freqs[i] = f;
+        m_displayBand[i] = j;
+        m_displayWeight[i] = std::clamp<Scalar>(
+            std::log(f / m_bandFreqs[j]) / std::log(m_bandFreqs[j + 1] / m_bandFreqs[j]),
+            0, 1);
+    }
+}
+
+void ConstantQSpectrum::restart(const int64_t time) {
+    m_coefs = std::make_unique<Coefs>(*m_analyzer);
+    m_analyzed = time;
+    m_completed = time;
+}
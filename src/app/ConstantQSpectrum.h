@@ -0,0 +1,92 @@
+#ifndef SOURCEMODEL__CONSTANT_Q_SPECTRUM_H
+#define SOURCEMODEL__CONSTANT_Q_SPECTRUM_H
+
+#include <cstdint>
+#include <gaborator/gaborator.h>
+#include <memory>
+#include <vector>
+
+#include "math/FrequencyScale.h"
+#include "math/utils.h"
+
+class BufferedGenerator;
+
+/* Constant-Q spectrum of a generator's output, from a gaborator analysis.
+ *
+ * Every update() analyzes only the samples produced since the previous one, read from
+ * the end of the generator's ring buffer at their absolute sample times, so that the
+ * analysis carries on where it left off. The level of a band is the RMS of its
+ * coefficients that became final since the last update, which happens once the
+ * analysis has seen their whole support (see latency()).
+ *
+ * The bands are geometrically spaced, bandsPerOctave per octave from minFrequency, so
+ * they are much narrower than FFT bins at low frequencies. For display they are
+ * resampled onto points evenly spaced on the selected frequency scale.
+ */
+class ConstantQSpectrum {
+   public:
+    ConstantQSpectrum(BufferedGenerator* generator, int bandsPerOctave = 48,
+                      Scalar minFrequency = 50);
+    ~ConstantQSpectrum();
+
+    void setSampleRate(Scalar fs);
+
+    FrequencyScale frequencyScale() const;
+    void           setFrequencyScale(FrequencyScale scale);
+
+    void update();
+
+    // Display points, on the same dB scale as GeneratorSpectrum.
+    const Scalar* frequencies() const;
+    const Scalar* magnitudesDb() const;
+    int           binCount() const;
+
+    int bandCount() const;
+
+    // Delay of the levels behind the generator output, in seconds.
+    Scalar latency() const;
+
+   private:
+    using Analyzer = gaborator::analyzer<Scalar>;
+    using Coefs = gaborator::coefs<Scalar>;
+
+    static constexpr int kDisplayPoints = 512;
+
+    void constructAnalyzer();
+    void constructDisplay();
+
+    // Starts a new analysis at time, after samples were missed.
+    void restart(int64_t time);
+
+    BufferedGenerator* m_generator;
+
+    int            m_bandsPerOctave;
+    Scalar         m_minFrequency;
+    Scalar         m_fs;
+    FrequencyScale m_scale;
+
+    std::unique_ptr<Analyzer> m_analyzer;
+    std::unique_ptr<Coefs>    m_coefs;
+    int                       m_firstBand;
+    int                       m_lastBand;  // Exclusive.
+    int64_t                   m_support;
+
+    std::vector<Scalar> m_buffer;
+    int64_t             m_analyzed;   // Samples before this time have been analyzed.
+    int64_t             m_completed;  // Coefficients before this time have been read.
+
+    // Per band, in order of increasing frequency.
+    std::vector<int>    m_bandPosition;  // Position of gaborator band (b - m_firstBand).
+    std::vector<Scalar> m_bandFreqs;
+    std::vector<Scalar> m_bandPower;
+    std::vector<int>    m_bandCoefCount;
+    std::vector<Scalar> m_bandLevels;
+
+    // Display points, each interpolated between two neighbouring bands.
+    std::vector<Scalar> m_freqs;
+    std::vector<Scalar> m_spls;
+    std::vector<int>    m_displayBand;
+    std::vector<Scalar> m_displayWeight;
+};
+
+#endif  // SOURCEMODEL__CONSTANT_Q_SPECTRUM_H
@@ -1,25 +1,25 @@
 #include "FilterSpectrum.h"
 
+#include <algorithm>
 #include <boost/math/constants/constants.hpp>
-#include <boost/math/tools/rational.hpp>
+#include <cmath>
+#include <limits>
 
+#include "math/VectorMath.h"
 #include "math/utils.h"
 
 using namespace boost::math::constants;
 
-FilterSpectrum::FilterSpectrum() : m_fs(48000) { setSize(1024); }
+FilterSpectrum::FilterSpectrum() : m_nfft(0), m_binCount(0), m_fs(48000) {
+    setSize(1024);
+}
 
 void FilterSpectrum::setSize(const int nfft) {
     if (m_nfft != nfft) {
         m_nfft = nfft;
-        m_dtft.setSampleCount(nfft);
-        // Fill data with zeroes
-        m_data.resize(m_nfft);
-        std::fill(m_data.begin(), m_data.end(), 0.0_f);
+        m_binCount = nfft / 2 + 1;
         // Reconstruct frequency array.
-        m_binCount = m_dtft.binCount();
         m_freqs.resize(m_binCount);
-        m_sectionMag.resize(m_binCount);
         m_mags.resize(m_binCount);
         m_spls.resize(m_binCount);
         for (int i = 0; i < m_binCount; ++i) {
@@ -27,6 +27,26 @@ void FilterSpectrum::setSize(const int nfft) {
             m_mags[i] = 0;
             m_spls[i] = -std::numeric_limits<Scalar>::infinity();
         }
+        // Unit circle at the bin frequencies.
+        m_cosW.resize(m_binCount);
+        m_sinW.resize(m_binCount);
+        m_cos2W.resize(m_binCount);
+        m_sin2W.resize(m_binCount);
+        for (int i = 0; i < m_binCount; ++i) {
+            const Scalar w = two_pi<Scalar>() * i / m_nfft;
+            m_cosW[i] = std::cos(w);
+            m_sinW[i] = std::sin(w);
+            m_cos2W[i] = std::cos(2 * w);
+            m_sin2W[i] = std::sin(2 * w);
+        }
+        m_branchPower.resize(m_binCount);
+        m_branchRe.resize(m_binCount);
+        m_branchIm.resize(m_binCount);
+        m_power.resize(m_binCount);
+        for (auto &power : m_sectionPower) {
+            power.resize(m_binCount);
+        }
+        invalidate();
     }
 }
 
@@ -39,19 +59,48 @@ void FilterSpectrum::setSampleRate(const Scalar fs) {
             m_mags[i] = 0;
             m_spls[i] = -std::numeric_limits<Scalar>::infinity();
         }
+        invalidate();
     }
 }
 
 void FilterSpectrum::update(const std::vector<std::array<Scalar, 6>> &sos) {
-    for (int i = 0; i < m_binCount; ++i) {
-        m_mags[i] = 1;
+    if (!m_branches.empty()) {
+        m_branches.clear();
+        invalidate();
+    }
+    setSectionCount(sos.size());
+
+    bool changed = false;
+    for (int k = 0; k < sos.size(); ++k) {
+        changed |= updateSection(k, sos[k]);
+    }
+    if (!changed) {
+        return;
+    }
+
+    std::fill(m_power.begin(), m_power.end(), 1.0_f);
+    finish();
+}
+
+void FilterSpectrum::updateParallel(const std::vector<std::array<Scalar, 6>> &branches,
+                                    const std::array<Scalar, 6>              &series) {
+    if (m_branches.empty()) {
+        invalidate();
     }
-    for (const auto &sec : sos) {
-        calculateOneSection(sec);
+    setSectionCount(1);
+
+    bool changed = updateSection(0, series);
+    if (branches != m_branches) {
+        m_branches = branches;
+        calculateBranchSum(branches);
+        changed = true;
     }
-    for (int i = 0; i < m_binCount; ++i) {
-        m_spls[i] = 10 * log10(m_mags[i]);
+    if (!changed) {
+        return;
     }
+
+    std::copy(m_branchPower.begin(), m_branchPower.end(), m_power.begin());
+    finish();
 }
 
 const Scalar *FilterSpectrum::frequencies() const { return m_freqs.data(); }
@@ -62,16 +111,99 @@ const Scalar *FilterSpectrum::magnitudesDb() const { return m_spls.data(); }
 
 int FilterSpectrum::binCount() const { return m_binCount; }
 
-void FilterSpectrum::calculateOneSection(const std::array<Scalar, 6> &sec) {
-    // Calculate for b
-    std::copy(sec.begin(), std::next(sec.begin(), 3), m_data.begin());
-    m_dtft.updateSamples(m_data.data(), m_nfft);
-    std::copy(m_dtft.magnitude(), m_dtft.magnitude() + m_binCount, m_sectionMag.begin());
-
-    // Calculate for a
-    std::copy(std::next(sec.begin(), 3), std::next(sec.begin(), 6), m_data.begin());
-    m_dtft.updateSamples(m_data.data(), m_nfft);
-    for (int i = 0; i < m_binCount; ++i) {
-        m_mags[i] *= (m_sectionMag[i] / m_dtft.magnitude()[i]);
+void FilterSpectrum::invalidate() {
+    // NaN coefficients never compare equal, so every section gets recomputed.
+    Section invalid;
+    invalid.fill(std::numeric_limits<Scalar>::quiet_NaN());
+    std::fill(m_sections.begin(), m_sections.end(), invalid);
+    m_branches.clear();
+}
+
+void FilterSpectrum::setSectionCount(const int count) {
+    if (m_sections.size() != count) {
+        m_sections.resize(count);
+        m_sectionPower.resize(count, std::vector<Scalar>(m_binCount));
+        invalidate();
     }
-}
\ No newline at end of file
+}
+
+bool FilterSpectrum::updateSection(const int k, const Section &sec) {
+    if (sec == m_sections[k]) {
+        return false;
+    }
+    m_sections[k] = sec;
+
+    // |b0 + b1 z^-1 + b2 z^-2|^2 on the unit circle is
+    //   b0^2 + b1^2 + b2^2 + 2 (b0 b1 + b1 b2) cos w + 2 b0 b2 cos 2w,
+    // and the same for a.
+    const Scalar n0 = sec[0] * sec[0] + sec[1] * sec[1] + sec[2] * sec[2];
+    const Scalar n1 = 2 * (sec[0] * sec[1] + sec[1] * sec[2]);
+    const Scalar n2 = 2 * sec[0] * sec[2];
+    const Scalar d0 = sec[3] * sec[3] + sec[4] * sec[4] + sec[5] * sec[5];
+    const Scalar d1 = 2 * (sec[3] * sec[4] + sec[4] * sec[5]);
+    const Scalar d2 = 2 * sec[3] * sec[5];
+
+    const int     binCount = m_binCount;
+    const Scalar *cosW = m_cosW.data();
+    const Scalar *cos2W = m_cos2W.data();
+    Scalar       *power = m_sectionPower[k].data();
+
+    for (int i = 0; i < binCount; ++i) {
+        const Scalar num = n0 + n1 * cosW[i] + n2 * cos2W[i];
+        const Scalar den = d0 + d1 * cosW[i] + d2 * cos2W[i];
+        power[i] = num / den;
+    }
+    return true;
+}
+
+void FilterSpectrum::calculateBranchSum(const std::vector<Section> &branches) {
+    // The branches add up with their phases, so sum the complex responses, with
+    // z^-1 = cos w - i sin w.
+    const int     binCount = m_binCount;
+    const Scalar *cosW = m_cosW.data();
+    const Scalar *sinW = m_sinW.data();
+    const Scalar *cos2W = m_cos2W.data();
+    const Scalar *sin2W = m_sin2W.data();
+    Scalar       *re = m_branchRe.data();
+    Scalar       *im = m_branchIm.data();
+
+    std::fill(re, re + binCount, 0.0_f);
+    std::fill(im, im + binCount, 0.0_f);
+
+    for (const auto &sec : branches) {
+        const auto [b0, b1, b2, a0, a1, a2] = sec;
+
+        for (int i = 0; i < binCount; ++i) {
+            const Scalar numRe = b0 + b1 * cosW[i] + b2 * cos2W[i];
+            const Scalar numIm = -(b1 * sinW[i] + b2 * sin2W[i]);
+            const Scalar denRe = a0 + a1 * cosW[i] + a2 * cos2W[i];
+            const Scalar denIm = -(a1 * sinW[i] + a2 * sin2W[i]);
+
+            const Scalar invDen = 1 / (denRe * denRe + denIm * denIm);
+            re[i] += (numRe * denRe + numIm * denIm) * invDen;
+            im[i] += (numIm * denRe - numRe * denIm) * invDen;
+        }
+    }
+
+    for (int i = 0; i < binCount; ++i) {
+        m_branchPower[i] = re[i] * re[i] + im[i] * im[i];
+    }
+}
+
+void FilterSpectrum::finish() {
+    const int binCount = m_binCount;
+    Scalar   *power = m_power.data();
+
+    for (const auto &sectionPower : m_sectionPower) {
+        const Scalar *section = sectionPower.data();
+        for (int i = 0; i < binCount; ++i) {
+            power[i] *= section[i];
+        }
+    }
+    Scalar *mags = m_mags.data();
+    Scalar *spls = m_spls.data();
+    for (int i = 0; i < binCount; ++i) {
+        mags[i] = std::sqrt(power[i]);
+        spls[i] = 10 * vmath::log10(mags[i]);
+    }
+}
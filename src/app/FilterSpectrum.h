@@ -4,9 +4,14 @@
 #include <array>
 #include <vector>
 
-#include "math/DTFT.h"
 #include "math/utils.h"
 
+/* Magnitude response of second-order sections on the bins of an nfft-point DFT.
+ *
+ * Each section is evaluated directly on the unit circle from cos/sin tables of the
+ * bin frequencies, and its squared magnitude is kept until its coefficients change,
+ * so an update where only some sections moved only recomputes those.
+ */
 class FilterSpectrum {
    public:
     FilterSpectrum();
@@ -14,27 +19,61 @@ class FilterSpectrum {
     void setSize(int nfft);
     void setSampleRate(Scalar fs);
 
+    // Response of sections in cascade.
     void update(const std::vector<std::array<Scalar, 6>>& sos);
 
+    // Response of the sum of the branches, in cascade with one more section.
+    void updateParallel(const std::vector<std::array<Scalar, 6>>& branches,
+                        const std::array<Scalar, 6>&              series);
+
     const Scalar* frequencies() const;
     const Scalar* magnitudes() const;
     const Scalar* magnitudesDb() const;
     int           binCount() const;
 
    private:
-    void calculateOneSection(const std::array<Scalar, 6>& section);
+    using Section = std::array<Scalar, 6>;
+
+    // Drops the cached responses so that the next update recomputes everything.
+    void invalidate();
+
+    // Resizes the cache for count sections, invalidating it if the count changed.
+    void setSectionCount(int count);
+
+    // Recomputes the cached response of section k if sec differs from the cached one.
+    bool updateSection(int k, const Section& sec);
+
+    // |H|^2 of the sum of the branches.
+    void calculateBranchSum(const std::vector<Section>& branches);
+
+    // Magnitudes and levels from the product of m_power and the cached sections.
+    void finish();
 
     int    m_nfft;
     int    m_binCount;
     Scalar m_fs;
 
     std::vector<Scalar> m_freqs;
-    std::vector<Scalar> m_sectionMag;
     std::vector<Scalar> m_mags;
     std::vector<Scalar> m_spls;
 
-    std::vector<Scalar> m_data;
-    DTFT<Scalar>        m_dtft;
+    // cos(w), sin(w), cos(2w), sin(2w) at each bin, w = 2 pi i / nfft.
+    std::vector<Scalar> m_cosW;
+    std::vector<Scalar> m_sinW;
+    std::vector<Scalar> m_cos2W;
+    std::vector<Scalar> m_sin2W;
+
+    // Coefficients and |H|^2 of every section from the last update.
+    std::vector<Section>             m_sections;
+    std::vector<std::vector<Scalar>> m_sectionPower;
+
+    // Parallel branches from the last updateParallel, empty in cascade.
+    std::vector<Section> m_branches;
+    std::vector<Scalar>  m_branchPower;
+    std::vector<Scalar>  m_branchRe;
+    std::vector<Scalar>  m_branchIm;
+
+    std::vector<Scalar> m_power;
 };
 
-#endif  // SOURCEMODEL__FILTER_SPECTRUM_H
\ No newline at end of file
+#endif  // SOURCEMODEL__FILTER_SPECTRUM_H
@@ -0,0 +1,251 @@
+#include "FormantFilterBank.h"
+
+#include <algorithm>
+#include <boost/math/constants/constants.hpp>
+#include <cmath>
+
+#include "math/VectorMath.h"
+
+using namespace boost::math::constants;
+
+FormantFilterBank::FormantFilterBank(const int formantCount, const Scalar fs)
+    : m_count(std::clamp(formantCount, 0, kLanes)),
+      m_fs(fs),
+      m_topology(Topology_Cascade),
+      m_coefs(),
+      m_rampRemaining(0),
+      m_step() {
+    // Unused lanes still run in parallel, keep them on a stable filter.
+    m_F.fill(1000);
+    m_B.fill(100);
+    m_state.z1.fill(0);
+    m_state.z2.fill(0);
+    update();
+}
+
+int FormantFilterBank::formantCount() const { return m_count; }
+
+Scalar FormantFilterBank::sampleRate() const { return m_fs; }
+
+void FormantFilterBank::setSampleRate(const Scalar fs) { m_fs = fs; }
+
+FormantFilterBank::Topology FormantFilterBank::topology() const { return m_topology; }
+
+void FormantFilterBank::setTopology(const Topology topology) {
+    if (m_topology != topology) {
+        m_topology = topology;
+        m_state.z1.fill(0);
+        m_state.z2.fill(0);
+    }
+}
+
+Scalar FormantFilterBank::frequency(const int k) const { return m_F[k]; }
+
+Scalar FormantFilterBank::bandwidth(const int k) const { return m_B[k]; }
+
+void FormantFilterBank::setFormant(const int k, const Scalar Fk, const Scalar Bk) {
+    m_F[k] = Fk;
+    m_B[k] = Bk;
+}
+
+void FormantFilterBank::update(const int rampLength) {
+    const Coefficients previous = m_coefs;
+
+    const int    count = m_count;
+    const Scalar fs = m_fs;
+
+    alignas(64) Lanes cosTheta;
+    alignas(64) Lanes sinTheta;
+
+    Coefficients& c = m_coefs;
+
+    for (int k = 0; k < kLanes; ++k) {
+        const Scalar Fk = std::min(m_F[k], fs / 2);
+        const Scalar Bk = m_B[k];
+
+        const Scalar r = vmath::exp(-pi<Scalar>() * Bk / fs);
+        cosTheta[k] = vmath::cos_pi(2 * Fk / fs);
+        sinTheta[k] = vmath::sin_pi(2 * Fk / fs);
+
+        const Scalar a1 = -2 * r * cosTheta[k];
+        const Scalar a2 = r * r;
+        const Scalar b0 = 1 + a1 + a2;
+
+        // SVFBiquad::update specialised to a stable resonator, where both
+        // m1 = -1 - a1 - a2 and m2 = -1 + a1 - a2 are negative.
+        const Scalar asm1 = std::sqrt(1 + a1 + a2);
+        const Scalar asm2 = std::sqrt(1 - a1 + a2);
+        const Scalar sm1mul2 = -asm1 * asm2;
+
+        c.g[k] = asm1 / asm2;
+        c.R[k] = (a2 - 1) / sm1mul2;
+        c.cHP[k] = b0 / (1 - a1 + a2);
+        c.cBP[k] = 2 * b0 / sm1mul2;
+        c.cLP[k] = b0 / (1 + a1 + a2);
+
+        m_b0[k] = b0;
+        m_a1[k] = a1;
+        m_a2[k] = a2;
+    }
+
+    // Parallel gain of formant k: the magnitude of the other formants at F_k, so that
+    // the sum has the same peaks as the cascade. The signs alternate so that
+    // neighbouring resonators, which are in opposite phase between their peaks, add
+    // up instead of cancelling out.
+    alignas(64) Lanes num;
+    alignas(64) Lanes den;
+    num.fill(1);
+    den.fill(1);
+    for (int j = 0; j < count; ++j) {
+        const Scalar b0 = m_b0[j];
+        const Scalar a1 = m_a1[j];
+        const Scalar a2 = m_a2[j];
+
+        for (int k = 0; k < kLanes; ++k) {
+            // |A_j(e^-i theta_k)|^2
+            const Scalar cos2Theta = 2 * cosTheta[k] * cosTheta[k] - 1;
+            const Scalar sin2Theta = 2 * sinTheta[k] * cosTheta[k];
+            const Scalar re = 1 + a1 * cosTheta[k] + a2 * cos2Theta;
+            const Scalar im = a1 * sinTheta[k] + a2 * sin2Theta;
+
+            // Numerators and denominators are multiplied separately, to divide once.
+            num[k] *= vmath::select(j == k, Scalar(1), b0 * b0);
+            den[k] *= vmath::select(j == k, Scalar(1), re * re + im * im);
+        }
+    }
+    for (int k = 0; k < kLanes; ++k) {
+        const Scalar sign = vmath::select(k % 2 == 0, Scalar(1), Scalar(-1));
+        const Scalar gain = sign * std::sqrt(num[k] / den[k]);
+        c.gain[k] = vmath::select(k < count, gain, Scalar(0));
+    }
+
+    if (rampLength > 1) {
+        const Scalar invLength = Scalar(1) / rampLength;
+        for (int k = 0; k < kLanes; ++k) {
+            m_step.g[k] = (c.g[k] - previous.g[k]) * invLength;
+            m_step.R[k] = (c.R[k] - previous.R[k]) * invLength;
+            m_step.cHP[k] = (c.cHP[k] - previous.cHP[k]) * invLength;
+            m_step.cBP[k] = (c.cBP[k] - previous.cBP[k]) * invLength;
+            m_step.cLP[k] = (c.cLP[k] - previous.cLP[k]) * invLength;
+            m_step.gain[k] = (c.gain[k] - previous.gain[k]) * invLength;
+        }
+
+        // Start from where we were, the first sample takes the first step.
+        m_coefs = previous;
+        m_rampRemaining = rampLength;
+    } else {
+        m_rampRemaining = 0;
+    }
+
+    derive(m_coefs, m_derived);
+}
+
+void FormantFilterBank::process(const Scalar* in, Scalar* out, const int n) {
+    if (m_topology == Topology_Parallel) {
+        processWith<Topology_Parallel>(in, out, n);
+    } else {
+        processWith<Topology_Cascade>(in, out, n);
+    }
+}
+
+std::array<Scalar, 6> FormantFilterBank::biquadCoefficients(const int k) const {
+    const Scalar b0 =
+        m_topology == Topology_Parallel ? m_coefs.gain[k] * m_b0[k] : m_b0[k];
+    return {b0, 0, 0, 1, m_a1[k], m_a2[k]};
+}
+
+void FormantFilterBank::derive(const Coefficients& c, Derived& d) {
+    for (int k = 0; k < kLanes; ++k) {
+        d.R2g[k] = 2 * c.R[k] + c.g[k];
+        d.invDen[k] = 1 / (1 + 2 * c.R[k] * c.g[k] + c.g[k] * c.g[k]);
+    }
+}
+
+inline Scalar FormantFilterBank::tickCascade(Scalar x, const int count,
+                                             const Coefficients& c, const Derived& d,
+                                             State& s) {
+    for (int k = 0; k < count; ++k) {
+        const Scalar HP = (x - d.R2g[k] * s.z1[k] - s.z2[k]) * d.invDen[k];
+        const Scalar BP = HP * c.g[k] + s.z1[k];
+        const Scalar LP = BP * c.g[k] + s.z2[k];
+
+        s.z1[k] = c.g[k] * HP + BP;
+        s.z2[k] = c.g[k] * BP + LP;
+
+        x = c.cHP[k] * HP + c.cBP[k] * BP + c.cLP[k] * LP;
+    }
+    return x;
+}
+
+inline Scalar FormantFilterBank::tickParallel(const Scalar x, const Coefficients& c,
+                                              const Derived& d, State& s) {
+    alignas(64) Lanes y;
+
+    for (int k = 0; k < kLanes; ++k) {
+        const Scalar HP = (x - d.R2g[k] * s.z1[k] - s.z2[k]) * d.invDen[k];
+        const Scalar BP = HP * c.g[k] + s.z1[k];
+        const Scalar LP = BP * c.g[k] + s.z2[k];
+
+        s.z1[k] = c.g[k] * HP + BP;
+        s.z2[k] = c.g[k] * BP + LP;
+
+        y[k] = c.gain[k] * (c.cHP[k] * HP + c.cBP[k] * BP + c.cLP[k] * LP);
+    }
+
+    // Pairwise sum, written so that each step is a vector add.
+    for (int width = kLanes / 2; width > 0; width /= 2) {
+        for (int k = 0; k < width; ++k) {
+            y[k] += y[k + width];
+        }
+    }
+    return y[0];
+}
+
+template <FormantFilterBank::Topology topology>
+void FormantFilterBank::processWith(const Scalar* in, Scalar* out, const int n) {
+    const int count = m_count;
+
+    int i = 0;
+
+    for (; i < n && m_rampRemaining > 0; ++i) {
+        stepRamp();
+        if constexpr (topology == Topology_Parallel) {
+            out[i] = tickParallel(in[i], m_coefs, m_derived, m_state);
+        } else {
+            out[i] = tickCascade(in[i], count, m_coefs, m_derived, m_state);
+        }
+    }
+
+    // Coefficients are constant from here, work on local copies so that the compiler
+    // knows they don't alias the output.
+    const Coefficients c = m_coefs;
+    const Derived      d = m_derived;
+    State              s = m_state;
+
+    for (; i < n; ++i) {
+        if constexpr (topology == Topology_Parallel) {
+            out[i] = tickParallel(in[i], c, d, s);
+        } else {
+            out[i] = tickCascade(in[i], count, c, d, s);
+        }
+    }
+
+    m_state = s;
+}
+
+void FormantFilterBank::stepRamp() {
+    Coefficients&       c = m_coefs;
+    const Coefficients& dc = m_step;
+
+    for (int k = 0; k < kLanes; ++k) {
+        c.g[k] += dc.g[k];
+        c.R[k] += dc.R[k];
+        c.cHP[k] += dc.cHP[k];
+        c.cBP[k] += dc.cBP[k];
+        c.cLP[k] += dc.cLP[k];
+        c.gain[k] += dc.gain[k];
+    }
+    m_rampRemaining--;
+
+    derive(m_coefs, m_derived);
+}
@@ -0,0 +1,112 @@
+#ifndef SOURCEMODEL__FORMANT_FILTER_BANK_H
+#define SOURCEMODEL__FORMANT_FILTER_BANK_H
+
+#include <array>
+
+#include "math/utils.h"
+
+/* All the formant resonators of a vocal tract, one per SIMD lane.
+ *
+ * Each formant is a two-pole resonator with unit gain at DC, realized as an SVF like
+ * SVFBiquad, but the coefficients and states of all formants are stored as
+ * arrays of kLanes so that designing them (F, B -> r, cos theta -> g, R) is a single
+ * vectorized loop.
+ *
+ * The formants either run in cascade, or in parallel like the Klatt parallel branch:
+ * every resonator filters the input and the outputs are summed, with alternating
+ * signs and gains that match the cascade at each formant peak. In parallel the
+ * per-sample work is the same for every lane and vectorizes too.
+ */
+class FormantFilterBank {
+   public:
+    // 8 floats or 2 x 4 doubles in AVX2 registers. Unused lanes have zero gain.
+    static constexpr int kLanes = 8;
+
+    enum Topology {
+        Topology_Cascade,
+        Topology_Parallel,
+    };
+
+    FormantFilterBank(int formantCount, Scalar fs = 48000);
+
+    int formantCount() const;
+
+    Scalar sampleRate() const;
+    void   setSampleRate(Scalar fs);
+
+    // Clears the filter memories when the topology changes.
+    Topology topology() const;
+    void     setTopology(Topology topology);
+
+    Scalar frequency(int k) const;
+    Scalar bandwidth(int k) const;
+    void   setFormant(int k, Scalar Fk, Scalar Bk);
+
+    // Recomputes the coefficients of every formant. With rampLength > 0 the filters
+    // glide to them over that many samples instead of switching at once.
+    void update(int rampLength = 0);
+
+    // in and out may be the same buffer.
+    void process(const Scalar* in, Scalar* out, int n);
+
+    // Section k as {b0, b1, b2, a0, a1, a2}. In parallel, the numerator includes the
+    // branch gain.
+    std::array<Scalar, 6> biquadCoefficients(int k) const;
+
+   private:
+    using Lanes = std::array<Scalar, kLanes>;
+
+    struct Coefficients {
+        alignas(64) Lanes g;
+        alignas(64) Lanes R;
+        alignas(64) Lanes cHP;
+        alignas(64) Lanes cBP;
+        alignas(64) Lanes cLP;
+        alignas(64) Lanes gain;  // Parallel branch gain.
+    };
+
+    struct State {
+        alignas(64) Lanes z1;
+        alignas(64) Lanes z2;
+    };
+
+    // Derived from g and R, same as SVFBiquad.
+    struct Derived {
+        alignas(64) Lanes R2g;     // 2R + g
+        alignas(64) Lanes invDen;  // 1 / (1 + 2Rg + g^2)
+    };
+
+    static void derive(const Coefficients& c, Derived& d);
+
+    static Scalar tickCascade(Scalar x, int count, const Coefficients& c,
+                              const Derived& d, State& s);
+    static Scalar tickParallel(Scalar x, const Coefficients& c, const Derived& d,
+                               State& s);
+
+    template <Topology topology>
+    void processWith(const Scalar* in, Scalar* out, int n);
+
+    void stepRamp();
+
+    int      m_count;
+    Scalar   m_fs;
+    Topology m_topology;
+
+    alignas(64) Lanes m_F;
+    alignas(64) Lanes m_B;
+
+    // Direct form of each section, for biquadCoefficients.
+    alignas(64) Lanes m_b0;
+    alignas(64) Lanes m_a1;
+    alignas(64) Lanes m_a2;
+
+    Coefficients m_coefs;
+    Derived      m_derived;
+    State        m_state;
+
+    // Per-sample increments while ramping.
+    int          m_rampRemaining;
+    Coefficients m_step;
+};
+
+#endif  // SOURCEMODEL__FORMANT_FILTER_BANK_H
@@ -1,7 +1,9 @@
 #include "FormantGenerator.h"
 
+#include <algorithm>
 #include <boost/math/special_functions/sin_pi.hpp>
 
+
 using namespace std::placeholders;
 
 using boost::math::sin_pi;
@@ -37,10 +39,15 @@ FormantGenerator::FormantGenerator(const AudioTime&           time,
                  {"B4", 130, minBv, maxBv},
                  {"B5", 140, minBv, maxBv}}),
       m_paramFlutter("Ffmax", 0.03, 0, 0.5),
-      m_paramFlutterToggle("Ffon", true) {
+      m_paramFlutterToggle("Ffon", true),
+      m_paramParallel("Fpar", false),
+      m_controlPeriod(kDefaultControlPeriod),
+      m_parallel(false),
+      m_filters(kNumFormants) {
     m_paramFlutter.valueChanged.connect(&FormantGenerator::handleParamChanged, this);
     m_paramFlutterToggle.valueChanged.connect(&FormantGenerator::handleParamChanged,
                                               this);
+    m_paramParallel.valueChanged.connect(&FormantGenerator::handleParamChanged, this);
 
     m_Ffmax = m_paramFlutter.createParamFrom();
 
@@ -53,11 +60,7 @@ FormantGenerator::FormantGenerator(const AudioTime&           time,
         const Scalar fk = m_targetF[k].value();
         const Scalar bk = m_targetB[k].value();
 
-        m_filters[k].setFrequency(fk);
-        m_filters[k].setBandwidth(bk);
-
-        m_targetF[k].setValue(m_filters[k].frequency());
-        m_targetB[k].setValue(m_filters[k].bandwidth());
+        m_filters.setFormant(k, fk, bk);
 
         m_targetF[k].valueChanged.connect(std::bind(
             std::mem_fn(&FormantGenerator::handleFrequencyChanged), this, k, _1, _2));
@@ -68,6 +71,10 @@ FormantGenerator::FormantGenerator(const AudioTime&           time,
         m_B[k] = createParam(m_targetB[k].value(), maxBv, minBv, m_targetB[k].name());
     }
 
+    m_filters.update();
+
+    // No radiation: the coefficient used to be left unset, which in practice was 0.
+    m_lipRadiationCoeff = 0;
     m_lipRadiationMemory = 0;
 }
 
@@ -79,6 +86,14 @@ ScalarParameter& FormantGenerator::flutter() { return m_paramFlutter; }
 
 ToggleParameter& FormantGenerator::flutterToggle() { return m_paramFlutterToggle; }
 
+ToggleParameter& FormantGenerator::parallelToggle() { return m_paramParallel; }
+
+int FormantGenerator::controlPeriod() const { return m_controlPeriod; }
+
+void FormantGenerator::setControlPeriod(const int samples) {
+    m_controlPeriod = std::max(samples, 1);
+}
+
 void FormantGenerator::handleFrequencyChanged(const int k, const std::string& name,
                                               const Scalar Fk) {
     m_F[k]->linearRampToValueAtTime(Fk, time() + 0.15_f);
@@ -96,6 +111,9 @@ void FormantGenerator::handleParamChanged(const std::string& name, const Scalar
         // If on => set Ffmax to current value of paramFlutter
         // If off => set Ffmax to 0
         m_Ffmax->linearRampToValueAtTime(value * m_paramFlutter.value(), time() + 0.1_f);
+    } else if (name == "Fpar") {
+        m_parallel = (value != 0);
+        m_mustRegenSpectrum = true;
     }
 }
 
@@ -112,43 +130,39 @@ void FormantGenerator::updateSpectrumIfNeeded() {
 
 void FormantGenerator::fillInternalBuffer(std::vector<Scalar>& out) {
     if (hasSampleRateChanged()) {
-        for (auto& filter : m_filters) {
-            filter.setSampleRate(fs());
-        }
-        m_spectrum.setSampleRate(fs());
+        // The spectrum is read by the UI thread, which also sets its rate.
+        m_filters.setSampleRate(fs());
         ackSampleRateChange();
     }
 
+    m_filters.setTopology(m_parallel ? FormantFilterBank::Topology_Parallel
+                                     : FormantFilterBank::Topology_Cascade);
+
     const Scalar     d = m_lipRadiationCoeff;
     constexpr Scalar g = 0.25_f;  // Lip filter normalized to -6dB gain at DC.
 
-    for (int i = 0; i < out.size(); ++i) {
-        const Scalar t = time(i);
+    const int controlPeriod = m_controlPeriod;
 
-        Scalar y = m_input[i];
+    for (int start = 0; start < out.size(); start += controlPeriod) {
+        const int length = std::min<int>(controlPeriod, out.size() - start);
 
-        const Scalar Ffmax = m_Ffmax->valueForTime(t);
+        if (controlPeriod == 1) {
+            updateFilters(time(start), 0);
+        } else {
+            // Ramp to the values at the end of this segment.
+            updateFilters(time(start + length), length);
+        }
 
-        for (int k = 0; k < kNumFormants; ++k) {
-            const Scalar Fk = m_F[k]->valueForTime(t);
-            const Scalar Bk = m_B[k]->valueForTime(t);
+        m_filters.process(&m_input[start], &out[start], length);
 
-            // Mod each formant time
-            const Scalar tk = (1 - .2 * (k - kNumFormants / 2)) * (t + .5 * k);
-            const Scalar Fln = .1 * (sin_pi(2 * 12.7 * tk) + sin_pi(2 * 7.1 * tk) +
-                                     sin_pi(2 * 4.7 * tk));
+        for (int i = start; i < start + length; ++i) {
+            const Scalar y = out[i];
 
-            m_filters[k].setFrequency(Fk * (1 + Ffmax * Fln));
-            m_filters[k].setBandwidth(Bk * (1 + Ffmax * Fln));
+            // Lip radiation filter is a 1st order FIR filter.
+            out[i] = g / (1 - d) * y - g * d / (1 - d) * m_lipRadiationMemory;
 
-            m_filters[k].update();
-            y = m_filters[k].tick(y);
+            m_lipRadiationMemory = y;
         }
-
-        // Lip radiation filter is a 1st order FIR filter.
-        out[i] = g / (1 - d) * y - g * d / (1 - d) * m_lipRadiationMemory;
-
-        m_lipRadiationMemory = y;
     }
 
     // Prune past parameter events
@@ -161,12 +175,37 @@ void FormantGenerator::fillInternalBuffer(std::vector<Scalar>& out) {
     m_mustRegenSpectrum = true;
 }
 
+void FormantGenerator::updateFilters(const Scalar t, const int rampLength) {
+    const Scalar Ffmax = m_Ffmax->valueForTime(t);
+
+    for (int k = 0; k < kNumFormants; ++k) {
+        const Scalar Fk = m_F[k]->valueForTime(t);
+        const Scalar Bk = m_B[k]->valueForTime(t);
+
+        // Mod each formant time
+        const Scalar tk = (1 - .2 * (k - kNumFormants / 2)) * (t + .5 * k);
+        const Scalar Fln = .1 * (sin_pi(2 * 12.7 * tk) + sin_pi(2 * 7.1 * tk) +
+                                 sin_pi(2 * 4.7 * tk));
+
+        m_filters.setFormant(k, Fk * (1 + Ffmax * Fln), Bk * (1 + Ffmax * Fln));
+    }
+
+    m_filters.update(rampLength);
+}
+
 void FormantGenerator::updateSpectrum() {
-    std::vector<std::array<Scalar, 6>> sos(kNumFormants + 1);
+    const Scalar                d = m_lipRadiationCoeff;
+    const std::array<Scalar, 6> lip = {1 / (1 - d), -d / (1 - d), 0, 1, 0, 0};
+
+    std::vector<std::array<Scalar, 6>> sos(kNumFormants);
     for (int i = 0; i < kNumFormants; ++i) {
-        sos[i] = m_filters[i].getBiquadCoefficients();
+        sos[i] = m_filters.biquadCoefficients(i);
+    }
+
+    if (m_filters.topology() == FormantFilterBank::Topology_Parallel) {
+        m_spectrum.updateParallel(sos, lip);
+    } else {
+        sos.push_back(lip);
+        m_spectrum.update(sos);
     }
-    const Scalar d = m_lipRadiationCoeff;
-    sos[kNumFormants] = {1 / (1 - d), -d / (1 - d), 0, 1, 0, 0};
-    m_spectrum.update(sos);
 }
\ No newline at end of file
@@ -7,7 +7,7 @@
 #include <atomic>
 
 #include "FilterSpectrum.h"
-#include "OneFormantFilter.h"
+#include "FormantFilterBank.h"
 #include "ScalarParameter.h"
 #include "ToggleParameter.h"
 #include "audio/BufferedGenerator.h"
@@ -21,12 +21,23 @@ class FormantGenerator : public BufferedGenerator {
 
     static constexpr int kNumFormants = 5;
 
+    // Samples between two evaluations of the formant parameters.
+    static constexpr int kDefaultControlPeriod = 32;
+
     ScalarParameter& frequency(int k);
     ScalarParameter& bandwidth(int k);
 
     ScalarParameter& flutter();
     ToggleParameter& flutterToggle();
 
+    // Formants in parallel (Klatt) instead of in cascade.
+    ToggleParameter& parallelToggle();
+
+    // Parameters and filter coefficients are evaluated every controlPeriod samples
+    // (k-rate) and the filters glide linearly in between. 1 evaluates every sample.
+    int  controlPeriod() const;
+    void setControlPeriod(int samples);
+
     void handleFrequencyChanged(int k, const std::string&, Scalar Fk);
     void handleBandwidthChanged(int k, const std::string&, Scalar Bk);
 
@@ -41,6 +52,9 @@ class FormantGenerator : public BufferedGenerator {
     void fillInternalBuffer(std::vector<Scalar>& out) override;
 
    private:
+    // Evaluates the parameters at time t and ramps the filters to them.
+    void updateFilters(Scalar t, int rampLength);
+
     void updateSpectrum();
 
     FilterSpectrum   m_spectrum;
@@ -58,9 +72,13 @@ class FormantGenerator : public BufferedGenerator {
 
     ScalarParameter m_paramFlutter;
     ToggleParameter m_paramFlutterToggle;
+    ToggleParameter m_paramParallel;
+
+    std::atomic_int  m_controlPeriod;
+    std::atomic_bool m_parallel;
 
-    // One filter per formant.
-    std::array<OneFormantFilter, kNumFormants> m_filters;
+    // One resonator per formant.
+    FormantFilterBank m_filters;
     // One extra filter for lip radiation.
     Scalar m_lipRadiationCoeff;   // leaking integrator coeff
     Scalar m_lipRadiationMemory;  // last input.
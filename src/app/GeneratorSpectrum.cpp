@@ -12,7 +12,13 @@ using boost::math::cos_pi;
 using boost::math::sin_pi;
 
 GeneratorSpectrum::GeneratorSpectrum(BufferedGenerator *initialGenerator)
-    : m_generator(initialGenerator), m_updatePeriod(512) {
+    : m_worker(nullptr),
+      m_nfft(0),
+      m_fs(48000),
+      m_responseTime(0),
+      m_generator(initialGenerator),
+      m_lastUpdate(0),
+      m_updatePeriod(512) {
     // Preallocate for max NFFT = 32768
     constexpr int maxNfft = 32768;
     constexpr int maxNbins = maxNfft / 2 + 1;
@@ -21,12 +27,25 @@ GeneratorSpectrum::GeneratorSpectrum(BufferedGenerator *initialGenerator)
     m_values.reserve(maxNfft);
     m_freqs.reserve(maxNbins);
     m_mags.reserve(maxNbins);
-    m_spls.reserve(maxNbins);
 }
 
-int GeneratorSpectrum::transformSize() const { return m_dtft.sampleCount(); }
+GeneratorSpectrum::~GeneratorSpectrum() { setWorker(nullptr); }
+
+void GeneratorSpectrum::setWorker(SpectrumWorker *worker) {
+    if (m_worker != nullptr) {
+        m_worker->remove(this);
+    }
+    m_worker = worker;
+    if (m_worker != nullptr) {
+        m_worker->add(this);
+    }
+}
+
+int GeneratorSpectrum::transformSize() const { return m_nfft; }
 
 void GeneratorSpectrum::setTransformSize(const int nfft) {
+    std::lock_guard lock(m_mutex);
+
     if (m_nfft != nfft) {
         m_nfft = nfft;
         m_dtft.setSampleCount(nfft);
@@ -40,6 +59,8 @@ void GeneratorSpectrum::setTransformSize(const int nfft) {
 Scalar GeneratorSpectrum::responseTime() const { return m_responseTime; }
 
 void GeneratorSpectrum::setResponseTime(const Scalar responseTime) {
+    std::lock_guard lock(m_mutex);
+
     if (!fuzzyEquals(m_responseTime, responseTime)) {
         m_responseTime = responseTime;
         constructSmoothingKernel();
@@ -47,6 +68,8 @@ void GeneratorSpectrum::setResponseTime(const Scalar responseTime) {
 }
 
 void GeneratorSpectrum::setSampleRate(const Scalar fs) {
+    std::lock_guard lock(m_mutex);
+
     if (!fuzzyEquals(m_fs, fs)) {
         m_fs = fs;
         constructFrequencyArray();
@@ -56,44 +79,70 @@ void GeneratorSpectrum::setSampleRate(const Scalar fs) {
 }
 
 void GeneratorSpectrum::setGenerator(BufferedGenerator *generator) {
+    std::lock_guard lock(m_mutex);
+
     m_generator = generator;
     generator->setBufferLength(m_nfft);
 }
 
 void GeneratorSpectrum::update() {
-    if (m_generator->hasEnoughSamplesSince(m_lastUpdate, m_updatePeriod)) {
-        m_lastUpdate = m_generator->copyBufferTo(m_values);
+    if (m_worker == nullptr) {
+        analyze();
+    }
+    m_results.fetch();
+}
+
+const Scalar *GeneratorSpectrum::frequencies() const {
+    return m_results.front().freqs.data();
+}
+
+const Scalar *GeneratorSpectrum::magnitudes() const {
+    return m_results.front().mags.data();
+}
+
+const Scalar *GeneratorSpectrum::magnitudesDb() const {
+    return m_results.front().spls.data();
+}
 
-        for (int i = 0; i < m_nfft; ++i) {
-            m_values[i] *= m_window[i];
-        }
+int GeneratorSpectrum::binCount() const { return m_results.front().freqs.size(); }
 
-        m_dtft.updateSamples(m_values.data(), m_nfft);
+void GeneratorSpectrum::analyze() {
+    std::lock_guard lock(m_mutex);
 
-        // Copy magnitude.
-        for (int i = 0; i < m_binCount; ++i) {
-            m_mags[i] = m_dtft.magnitude()[i];
-        }
+    if (!m_generator->hasEnoughSamplesSince(m_lastUpdate, m_updatePeriod)) {
+        return;
+    }
 
-        // Apply smoothing.
-        for (int i = 0; i < m_binCount; ++i) {
-            m_smoothedMags[i] = m_alpha * m_mags[i] + (1 - m_alpha) * m_smoothedMags[i];
-        }
+    m_lastUpdate = m_generator->copyBufferTo(m_values);
 
-        // Calculate SPL in dB.
-        for (int i = 0; i < m_binCount; ++i) {
-            m_spls[i] = 10 * std::log10(m_smoothedMags[i]);
-        }
+    for (int i = 0; i < m_nfft; ++i) {
+        m_values[i] *= m_window[i];
+    }
+
+    m_dtft.updateSamples(m_values.data(), m_nfft);
+
+    // Copy magnitude.
+    for (int i = 0; i < m_binCount; ++i) {
+        m_mags[i] = m_dtft.magnitude()[i];
     }
-}
 
-const Scalar *GeneratorSpectrum::frequencies() const { return m_freqs.data(); }
+    // Apply smoothing.
+    for (int i = 0; i < m_binCount; ++i) {
+        m_smoothedMags[i] = m_alpha * m_mags[i] + (1 - m_alpha) * m_smoothedMags[i];
+    }
 
-const Scalar *GeneratorSpectrum::magnitudes() const { return m_smoothedMags.data(); }
+    Result &result = m_results.back();
+    result.freqs.assign(m_freqs.begin(), m_freqs.end());
+    result.mags.assign(m_smoothedMags.begin(), m_smoothedMags.end());
+    result.spls.resize(m_binCount);
 
-const Scalar *GeneratorSpectrum::magnitudesDb() const { return m_spls.data(); }
+    // Calculate SPL in dB.
+    for (int i = 0; i < m_binCount; ++i) {
+        result.spls[i] = 10 * std::log10(m_smoothedMags[i]);
+    }
 
-int GeneratorSpectrum::binCount() const { return m_dtft.binCount(); }
+    m_results.publish();
+}
 
 void GeneratorSpectrum::constructWindow() {
     m_window.resize(m_nfft);
@@ -110,12 +159,10 @@ void GeneratorSpectrum::constructFrequencyArray() {
     m_binCount = m_dtft.binCount();
     m_freqs.resize(m_binCount);
     m_mags.resize(m_binCount);
-    m_spls.resize(m_binCount);
     m_smoothedMags.resize(m_binCount);
     for (int i = 0; i < m_binCount; ++i) {
         m_freqs[i] = (i * m_fs) / m_nfft;
         m_mags[i] = 0;
-        m_spls[i] = -std::numeric_limits<Scalar>::infinity();
         m_smoothedMags[i] = 0;
     }
 }
@@ -1,17 +1,30 @@
 #ifndef SOURCEMODEL__GENERATOR_SPECTRUM_H
 #define SOURCEMODEL__GENERATOR_SPECTRUM_H
 
+#include <mutex>
 #include <vector>
 
+#include "SpectrumWorker.h"
+#include "TripleBuffer.h"
 #include "math/DTFT.h"
 #include "math/utils.h"
 #include "math/windows.h"
 
 class BufferedGenerator;
 
-class GeneratorSpectrum {
+/* Smoothed FFT spectrum of a generator's output.
+ *
+ * Without a worker, update() analyzes the latest samples itself. With one, the worker
+ * analyzes them and update() only picks up the latest finished spectrum, the
+ * accessors always return a complete one.
+ */
+class GeneratorSpectrum : public SpectrumWorker::Analysis {
    public:
     GeneratorSpectrum(BufferedGenerator* initialGenerator);
+    ~GeneratorSpectrum();
+
+    // Analyze on worker (or null) from now on.
+    void setWorker(SpectrumWorker* worker);
 
     int  transformSize() const;
     void setTransformSize(int nfft);
@@ -30,11 +43,25 @@ class GeneratorSpectrum {
     const Scalar* magnitudesDb() const;
     int           binCount() const;
 
+    void analyze() override;
+
    private:
+    struct Result {
+        std::vector<Scalar> freqs;
+        std::vector<Scalar> mags;
+        std::vector<Scalar> spls;
+    };
+
     void constructWindow();
     void constructFrequencyArray();
     void constructSmoothingKernel();
 
+    SpectrumWorker*      m_worker;
+    TripleBuffer<Result> m_results;
+
+    // Analysis state, held by whoever analyzes.
+    std::mutex m_mutex;
+
     int    m_nfft;
     Scalar m_fs;
     Scalar m_responseTime;
@@ -53,7 +80,6 @@ class GeneratorSpectrum {
     int                 m_binCount;
     std::vector<Scalar> m_freqs;
     std::vector<Scalar> m_mags;
-    std::vector<Scalar> m_spls;
 
     DTFT<Scalar> m_dtft;
 };
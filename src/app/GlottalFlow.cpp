@@ -1,15 +1,13 @@
 #include "GlottalFlow.h"
 
-#include <boost/math/quadrature/gauss_kronrod.hpp>
 #include <cmath>
 
+#include "math/CumulativeIntegral.h"
 #include "models/KLGLOTT88.h"
 #include "models/LF.h"
 #include "models/RPlusPlus.h"
 #include "models/RosenbergC.h"
 
-using namespace boost::math::quadrature;
-
 GlottalFlow::GlottalFlow()
     : m_isDirty(false),
       m_sampleCount(0),
@@ -70,34 +68,26 @@ void GlottalFlow::updateSamples() {
         m_times[i] = i / Scalar(m_sampleCount);
 
         // Make sure to include Te to include the real peak in the plot.
-        if (i < m_sampleCount - 1 && m_times[i] < Te && Te < m_times[i + 1]) {
-            m_times[i] = Te;
+        if (i > 0 && m_times[i - 1] < Te && Te < m_times[i]) {
+            m_times[i - 1] = Te;
         }
+    }
 
-        m_flowDerivative[i] = m_model->evaluate(m_times[i]);
-
-        if (m_model->hasAntiderivative()) {
-            m_flow[i] = m_model->evaluateAntiderivative(m_times[i]);
-        } else {
-// Do faster integration on Emscripten
-#ifdef __EMSCRIPTEN__
-            m_flow[i] = gauss_kronrod<float, 15>::integrate(
-                [this](float t) -> float { return m_model->evaluate(t); }, 0, m_times[i],
-                15, 1e-3);
-#else
-    // Float / double
-    #if defined(USING_SINGLE_FLOAT)
-            m_flow[i] = gauss_kronrod<float, 15>::integrate(
-                [this](double t) -> double { return m_model->evaluate(t); }, 0,
-                m_times[i], 8, 1e-6);
-    #elif defined(USING_DOUBLE_FLOAT)
-            gauss_kronrod<double, 31>::integrate(
-                [this](double t) -> double { return m_model->evaluate(t); }, 0,
-                m_times[i], 15, 1e-6);
-    #endif
-#endif
-        }
+    m_model->evaluateBlock(m_times.data(), m_flowDerivative.data(), m_sampleCount);
 
+    if (m_model->hasAntiderivative()) {
+        m_model->evaluateAntiderivativeBlock(m_times.data(), m_flow.data(),
+                                             m_sampleCount);
+    } else {
+        cumulativeIntegral(
+            [this](const Scalar* t, Scalar* out, const int n) {
+                m_model->evaluateBlock(t, out, n);
+            },
+            0, m_times.data(), m_flow.data(), m_sampleCount, m_quadratureNodes,
+            m_quadratureValues);
+    }
+
+    for (int i = 0; i < m_sampleCount; ++i) {
         if (m_flowDerivative[i] < m_flowDerivativeMin.second) {
             m_flowDerivativeMin.second = m_flowDerivative[i];
             m_flowDerivativeMin.first = m_times[i];
@@ -75,6 +75,10 @@ class GlottalFlow {
     Scalar                    m_flowAmplitude;
     std::pair<Scalar, Scalar> m_flowMin;
     std::pair<Scalar, Scalar> m_flowMax;
+
+    // Scratch space to integrate models without an antiderivative.
+    std::vector<Scalar> m_quadratureNodes;
+    std::vector<Scalar> m_quadratureValues;
 };
 
 #endif  //  SOURCEMODEL__GLOTTAL_FLOW_H
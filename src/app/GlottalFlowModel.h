@@ -12,6 +12,20 @@ class GlottalFlowModel {
     virtual Scalar evaluate(Scalar t) const = 0;
     virtual Scalar evaluateAntiderivative(Scalar t) const { return 0; }
 
+    // Block versions for t in [0, 1], overridden with vectorizable kernels.
+    virtual void evaluateBlock(const Scalar* t, Scalar* out, const int n) const {
+        for (int i = 0; i < n; ++i) {
+            out[i] = evaluate(t[i]);
+        }
+    }
+
+    virtual void evaluateAntiderivativeBlock(const Scalar* t, Scalar* out,
+                                             const int n) const {
+        for (int i = 0; i < n; ++i) {
+            out[i] = evaluateAntiderivative(t[i]);
+        }
+    }
+
     virtual void fitParameters(GlottalFlowParameters& params) = 0;
     virtual void updateParameterBounds(GlottalFlowParameters& params) = 0;
 };
@@ -0,0 +1,129 @@
+#include "GlottalFlowTableWorker.h"
+
+#include <chrono>
+#include <system_error>
+
+#include "GlottalFlow.h"
+
+GlottalFlowTableWorker::GlottalFlowTableWorker(GlottalFlow& glottalFlow)
+    : m_glottalFlow(glottalFlow), m_wakeups(0), m_stop(false), m_isSynchronous(false) {
+    m_tables.reserve(kMaxTables);
+    m_freeTables.reserve(kMaxTables);
+
+    try {
+        m_thread = std::thread(&GlottalFlowTableWorker::run, this);
+    } catch (const std::system_error&) {
+        m_isSynchronous = true;
+    }
+}
+
+GlottalFlowTableWorker::~GlottalFlowTableWorker() {
+    if (m_thread.joinable()) {
+        m_stop = true;
+        m_wakeups.fetch_add(1);
+        m_wakeups.notify_one();
+        m_thread.join();
+    }
+}
+
+bool GlottalFlowTableWorker::request(const Request& request) {
+    if (m_isSynchronous) {
+        prepare(request);
+        return true;
+    }
+
+    if (!m_requests.push(request)) {
+        return false;
+    }
+    m_wakeups.fetch_add(1);
+    m_wakeups.notify_one();
+    return true;
+}
+
+CachedGlottalFlowModel* GlottalFlowTableWorker::takeLatest() {
+    CachedGlottalFlowModel* latest = nullptr;
+    CachedGlottalFlowModel* table;
+    while (m_ready.pop(table)) {
+        if (latest != nullptr) {
+            retire(latest);
+        }
+        latest = table;
+    }
+    return latest;
+}
+
+void GlottalFlowTableWorker::retire(CachedGlottalFlowModel* table) {
+    // Can't fail: the queue has room for all kMaxTables tables.
+    m_retired.push(table);
+}
+
+void GlottalFlowTableWorker::run() {
+    while (!m_stop) {
+        const uint32_t wakeups = m_wakeups.load();
+
+        // Only the most recent parameters matter.
+        Request request;
+        bool    hasRequest = false;
+        while (m_requests.pop(request)) {
+            hasRequest = true;
+        }
+
+        if (hasRequest) {
+            prepare(request);
+        } else {
+            m_wakeups.wait(wakeups);
+        }
+    }
+}
+
+void GlottalFlowTableWorker::prepare(const Request& request) {
+    auto model = m_glottalFlow.genModel().lock();
+    if (!model) {
+        // genModel expired
+        return;
+    }
+
+    CachedGlottalFlowModel* table;
+    while (m_retired.pop(table)) {
+        m_freeTables.push_back(table);
+    }
+
+    // Once all tables exist, the others are played or ready, and the audio thread
+    // retires one every period.
+    while (m_freeTables.empty()) {
+        if (m_retired.pop(table)) {
+            m_freeTables.push_back(table);
+        } else if (m_tables.size() < kMaxTables) {
+            m_tables.push_back(std::make_unique<CachedGlottalFlowModel>());
+            m_freeTables.push_back(m_tables.back().get());
+        } else if (m_stop || m_isSynchronous) {
+            return;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    table = m_freeTables.back();
+    m_freeTables.pop_back();
+
+    m_parameters.setUsingRd(request.usingRd);
+    model->updateParameterBounds(m_parameters);
+    if (request.usingRd) {
+        m_parameters.Rd.setValue(request.Rd);
+    } else {
+        m_parameters.Oq.setValue(request.Oq);
+        m_parameters.am.setValue(request.am);
+        m_parameters.Qa.setValue(request.Qa);
+    }
+    model->fitParameters(m_parameters);
+    table->updateCache(model.get());
+
+    // The audio thread empties the queue every period, wait for it if it's full.
+    while (!m_ready.push(table)) {
+        if (m_stop || m_isSynchronous) {
+            m_freeTables.push_back(table);
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef SOURCEMODEL__GLOTTAL_FLOW_TABLE_WORKER_H
+#define SOURCEMODEL__GLOTTAL_FLOW_TABLE_WORKER_H
+
+#include <atomic>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "CachedGlottalFlowModel.h"
+#include "GlottalFlowParameters.h"
+
+class GlottalFlow;
+
+/* Fits the generator model and fills its period table on a background thread.
+ *
+ * The audio thread submits parameter snapshots and picks up finished tables through
+ * single-producer single-consumer queues, so it never waits on the worker. Tables it
+ * no longer plays are handed back for reuse. Every table is owned by the worker.
+ */
+class GlottalFlowTableWorker {
+   public:
+    struct Request {
+        bool   usingRd;
+        Scalar Oq;
+        Scalar am;
+        Scalar Qa;
+        Scalar Rd;
+    };
+
+    GlottalFlowTableWorker(GlottalFlow& glottalFlow);
+    ~GlottalFlowTableWorker();
+
+    // Audio thread. Returns false if the queue is full, the request should be retried.
+    bool request(const Request& request);
+
+    // Audio thread. Most recent finished table, or null if none is ready.
+    // Older finished tables that were never played are retired automatically.
+    CachedGlottalFlowModel* takeLatest();
+
+    // Audio thread. Gives back a table that isn't played anymore.
+    void retire(CachedGlottalFlowModel* table);
+
+   private:
+    static constexpr int kQueueCapacity = 8;
+
+    // At most one table is played, kQueueCapacity are ready and one is being prepared.
+    static constexpr int kMaxTables = kQueueCapacity + 2;
+
+    template <typename T, int Capacity = kQueueCapacity>
+    using Queue = boost::lockfree::spsc_queue<T, boost::lockfree::capacity<Capacity>>;
+
+    void run();
+    void prepare(const Request& request);
+
+    GlottalFlow& m_glottalFlow;
+
+    // Only touched by the worker (or the caller of request() when synchronous).
+    GlottalFlowParameters                                m_parameters;
+    std::vector<std::unique_ptr<CachedGlottalFlowModel>> m_tables;
+    std::vector<CachedGlottalFlowModel*>                 m_freeTables;
+
+    Queue<Request>                 m_requests;
+    Queue<CachedGlottalFlowModel*> m_ready;
+    // Holds every table, so retiring never fails.
+    Queue<CachedGlottalFlowModel*, kMaxTables> m_retired;
+
+    std::atomic_uint32_t m_wakeups;
+    std::atomic_bool     m_stop;
+    std::thread          m_thread;
+
+    // No threads available (e.g. Emscripten without pthreads), prepare inline.
+    bool m_isSynchronous;
+};
+
+#endif  // SOURCEMODEL__GLOTTAL_FLOW_TABLE_WORKER_H
@@ -0,0 +1,157 @@
+#include "HarmonicSpectrum.h"
+
+#include <algorithm>
+#include <boost/math/constants/constants.hpp>
+#include <cmath>
+
+#include "SourceGenerator.h"
+#include "audio/BufferedGenerator.h"
+
+using namespace boost::math::constants;
+
+HarmonicSpectrum::HarmonicSpectrum(const SourceGenerator* source,
+                                   BufferedGenerator*     generator,
+                                   const int              periodsPerFrame)
+    : m_source(source),
+      m_generator(generator),
+      m_periodsPerFrame(periodsPerFrame),
+      m_fs(48000),
+      m_thirdFormant(2500),
+      m_frameStart(0),
+      m_frameEnd(0),
+      m_framePeriods(0),
+      m_f0(0),
+      m_coefs(kMaxHarmonics),
+      m_s1(kMaxHarmonics),
+      m_s2(kMaxHarmonics),
+      m_harmonicCount(0),
+      m_freqs(kMaxHarmonics),
+      m_amplitudes(kMaxHarmonics),
+      m_spls(kMaxHarmonics) {
+    m_periodStarts.reserve(SourceGenerator::kPeriodHistory);
+}
+
+void HarmonicSpectrum::setSampleRate(const Scalar fs) {
+    if (!fuzzyEquals(m_fs, fs)) {
+        m_fs = fs;
+        m_frameEnd = 0;
+        m_harmonicCount = 0;
+        m_f0 = 0;
+    }
+}
+
+int HarmonicSpectrum::periodsPerFrame() const { return m_periodsPerFrame; }
+
+void HarmonicSpectrum::setPeriodsPerFrame(const int count) { m_periodsPerFrame = count; }
+
+void HarmonicSpectrum::setThirdFormant(const Scalar frequency) {
+    m_thirdFormant = frequency;
+}
+
+void HarmonicSpectrum::update() {
+    const int length = m_generator->bufferLength();
+    m_buffer.resize(length);
+
+    const uint64_t end = m_generator->copyBufferTo(m_buffer);
+    const uint64_t start = end - std::min<uint64_t>(end, length);
+
+    m_source->copyPeriodStartsTo(m_periodStarts);
+
+    if (findFrame(start, end)) {
+        analyzeFrame(start);
+    }
+}
+
+Scalar HarmonicSpectrum::f0() const { return m_f0; }
+
+const Scalar* HarmonicSpectrum::frequencies() const { return m_freqs.data(); }
+
+const Scalar* HarmonicSpectrum::magnitudesDb() const { return m_spls.data(); }
+
+int HarmonicSpectrum::harmonicCount() const { return m_harmonicCount; }
+
+Scalar HarmonicSpectrum::amplitude(const int k) const {
+    return (k >= 1 && k <= m_harmonicCount) ? m_amplitudes[k - 1] : 0;
+}
+
+Scalar HarmonicSpectrum::h1() const { return 20 * std::log10(amplitude(1)); }
+
+Scalar HarmonicSpectrum::h2() const { return 20 * std::log10(amplitude(2)); }
+
+Scalar HarmonicSpectrum::h1h2() const { return h1() - h2(); }
+
+Scalar HarmonicSpectrum::h1a3() const {
+    if (m_harmonicCount == 0) {
+        return 0;
+    }
+    const int k = std::clamp<int>(std::lround(m_thirdFormant / m_f0), 1, m_harmonicCount);
+    return h1() - 20 * std::log10(amplitude(k));
+}
+
+bool HarmonicSpectrum::findFrame(const uint64_t bufferStart, const uint64_t bufferEnd) {
+    const auto& starts = m_periodStarts;
+
+    // The last period start that is already in the buffer ends the frame.
+    const auto it = std::upper_bound(starts.begin(), starts.end(), double(bufferEnd));
+    const int  last = std::distance(starts.begin(), it) - 1;
+    if (last < 1 || starts[last] == m_frameEnd) {
+        return false;
+    }
+
+    int periods = std::min(m_periodsPerFrame, last);
+    while (periods > 0 && starts[last - periods] < bufferStart) {
+        --periods;
+    }
+    if (periods == 0) {
+        return false;
+    }
+
+    m_frameStart = starts[last - periods];
+    m_frameEnd = starts[last];
+    m_framePeriods = periods;
+    return true;
+}
+
+void HarmonicSpectrum::analyzeFrame(const uint64_t bufferStart) {
+    const int first = std::llround(m_frameStart) - bufferStart;
+    const int last =
+        std::min<int>(std::llround(m_frameEnd) - bufferStart, m_buffer.size());
+    const int n = last - first;
+
+    m_f0 = m_framePeriods * m_fs / (m_frameEnd - m_frameStart);
+    m_harmonicCount =
+        std::clamp<int>(std::ceil(m_fs / (2 * m_f0)) - 1, 0, kMaxHarmonics);
+
+    const int count = m_harmonicCount;
+
+    // Harmonic k + 1 makes exactly (k + 1) * periods cycles over the n samples. The
+    // resonators run in double, they lose precision at low frequencies otherwise.
+    double* coefs = m_coefs.data();
+    double* s1 = m_s1.data();
+    double* s2 = m_s2.data();
+    for (int k = 0; k < count; ++k) {
+        coefs[k] = 2 * std::cos(two_pi<double>() * (k + 1) * m_framePeriods / n);
+        s1[k] = 0;
+        s2[k] = 0;
+    }
+
+    // Every sample goes through the whole bank, the inner loop vectorizes.
+    for (int i = first; i < last; ++i) {
+        const double x = m_buffer[i];
+        for (int k = 0; k < count; ++k) {
+            const double s0 = x + coefs[k] * s1[k] - s2[k];
+            s2[k] = s1[k];
+            s1[k] = s0;
+        }
+    }
+
+    for (int k = 0; k < count; ++k) {
+        const double power = s1[k] * s1[k] + s2[k] * s2[k] - coefs[k] * s1[k] * s2[k];
+        const Scalar magnitude = std::sqrt(std::max(power, 0.0)) / n;
+
+        m_freqs[k] = (k + 1) * m_f0;
+        m_amplitudes[k] = 2 * magnitude;
+        // 10 log10 of |X| / N like GeneratorSpectrum, with a rectangular window.
+        m_spls[k] = 10 * std::log10(magnitude);
+    }
+}
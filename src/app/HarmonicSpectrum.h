@@ -0,0 +1,90 @@
+#ifndef SOURCEMODEL__HARMONIC_SPECTRUM_H
+#define SOURCEMODEL__HARMONIC_SPECTRUM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "math/utils.h"
+
+class BufferedGenerator;
+class SourceGenerator;
+
+/* Levels of the harmonics of a generator's output, at multiples of the source's f0.
+ *
+ * The source says where its periods start, so every frame spans exactly the last
+ * periodsPerFrame() periods in the ring buffer (fewer if they don't fit) and its f0
+ * is known exactly. A bank of Goertzel resonators tuned to k * f0 then gives the
+ * amplitude of every harmonic below Nyquist without any window leakage, at a cost
+ * proportional to the number of harmonics rather than to a transform size.
+ *
+ * A generator downstream of the source sees the same periods, shifted by its own
+ * delay, which doesn't change the levels of a periodic signal.
+ */
+class HarmonicSpectrum {
+   public:
+    static constexpr int kMaxHarmonics = 128;
+
+    HarmonicSpectrum(const SourceGenerator* source, BufferedGenerator* generator,
+                     int periodsPerFrame = 4);
+
+    void setSampleRate(Scalar fs);
+
+    int  periodsPerFrame() const;
+    void setPeriodsPerFrame(int count);
+
+    // Frequency used for A3, the level of the harmonic closest to F3.
+    void setThirdFormant(Scalar frequency);
+
+    // Analyzes the last frame if a period has completed since the previous one.
+    void update();
+
+    // f0 of the last frame, 0 until there was one.
+    Scalar f0() const;
+
+    // Harmonic k + 1 is at frequencies()[k]. Levels are on the same dB scale as
+    // GeneratorSpectrum, for plotting them together.
+    const Scalar* frequencies() const;
+    const Scalar* magnitudesDb() const;
+    int           harmonicCount() const;
+
+    // Amplitude of harmonic k (from 1), as the peak amplitude of its sinusoid.
+    Scalar amplitude(int k) const;
+
+    // The usual voice quality measures, in dB of amplitude.
+    Scalar h1() const;
+    Scalar h2() const;
+    Scalar h1h2() const;
+    Scalar h1a3() const;
+
+   private:
+    // Returns false if no new complete period fits in the buffer.
+    bool findFrame(uint64_t bufferStart, uint64_t bufferEnd);
+    void analyzeFrame(uint64_t bufferStart);
+
+    const SourceGenerator* m_source;
+    BufferedGenerator*     m_generator;
+    int                    m_periodsPerFrame;
+    Scalar                 m_fs;
+    Scalar                 m_thirdFormant;
+
+    std::vector<Scalar> m_buffer;
+    std::vector<double> m_periodStarts;
+
+    // Last frame, in samples since the clock started.
+    double m_frameStart;
+    double m_frameEnd;
+    int    m_framePeriods;
+    Scalar m_f0;
+
+    // Goertzel state, one per harmonic.
+    std::vector<double> m_coefs;
+    std::vector<double> m_s1;
+    std::vector<double> m_s2;
+
+    int                 m_harmonicCount;
+    std::vector<Scalar> m_freqs;
+    std::vector<Scalar> m_amplitudes;
+    std::vector<Scalar> m_spls;
+};
+
+#endif  // SOURCEMODEL__HARMONIC_SPECTRUM_H
@@ -1,8 +1,11 @@
 #include "SourceGenerator.h"
 
+#include <algorithm>
 #include <boost/math/special_functions/sin_pi.hpp>
+#include <chrono>
 
 #include "GlottalFlow.h"
+#include "audio/RealtimeAudit.h"
 
 using boost::math::sin_pi;
 using nativeformat::param::createParam;
@@ -19,8 +22,14 @@ constexpr std::array<Scalar, 13> jitterDistributionDeviations = {
 SourceGenerator::SourceGenerator(const AudioTime& time, GlottalFlow& glottalFlow)
     : BufferedGenerator(time),
       m_glottalFlow(glottalFlow),
-      m_currentPeriod(0),
+      m_tableWorker(glottalFlow),
+      m_lastTableRequest{},
+      m_currentTable(nullptr),
+      m_usingRd(true),
+      m_phase(0),
+      m_phaseIncrement(0),
       m_internalParamChanged(true),
+      m_periodCount(0),
       m_paramF0("f0", 120, 16, 1000),
       m_paramFlutter("Fpmax", 0.02, 0, 0.5),
       m_paramJitter("Jmax", 0.005, 0, 0.2),
@@ -30,7 +39,13 @@ SourceGenerator::SourceGenerator(const AudioTime& time, GlottalFlow& glottalFlow
       m_paramShimmerToggle("Son", true),
       m_randomGenerator(m_randomDevice()),
       m_jitterDistribution(jitterDistributionWeights.begin(),
-                           jitterDistributionWeights.end()) {
+                           jitterDistributionWeights.end()),
+      m_oversampling(1),
+      m_currentOversampling(1),
+      m_decimator(nullptr),
+      m_decimatorLatency(0),
+      m_decimators{},
+      m_costPerSample(0) {
     m_paramF0.valueChanged.connect(&SourceGenerator::handleParamChanged, this);
     m_paramFlutter.valueChanged.connect(&SourceGenerator::handleParamChanged, this);
     m_paramJitter.valueChanged.connect(&SourceGenerator::handleParamChanged, this);
@@ -39,24 +54,24 @@ SourceGenerator::SourceGenerator(const AudioTime& time, GlottalFlow& glottalFlow
     m_paramJitterToggle.valueChanged.connect(&SourceGenerator::handleParamChanged, this);
     m_paramShimmerToggle.valueChanged.connect(&SourceGenerator::handleParamChanged, this);
 
-    m_gfmParameters.Oq.valueChanged.connect(&SourceGenerator::handleInternalParamChanged,
-                                            this);
-    m_gfmParameters.am.valueChanged.connect(&SourceGenerator::handleInternalParamChanged,
-                                            this);
-    m_gfmParameters.Qa.valueChanged.connect(&SourceGenerator::handleInternalParamChanged,
-                                            this);
-    m_gfmParameters.usingRdChanged.connect(&SourceGenerator::handleUsingRdChanged, this);
-    m_gfmParameters.Rd.valueChanged.connect(&SourceGenerator::handleInternalParamChanged,
-                                            this);
+    GlottalFlowParameters defaults;
 
     m_f0 = m_paramF0.createParamFrom();
     m_Fpmax = m_paramFlutter.createParamFrom();
     m_Jmax = m_paramJitter.createParamFrom();
     m_Smax = m_paramShimmer.createParamFrom();
-    m_Rd = m_gfmParameters.Rd.createParamFrom();
-    m_Oq = createParam(m_gfmParameters.Oq.value(), 1.0f, 0.0f, "Oq");
-    m_am = createParam(m_gfmParameters.am.value(), 1.0f, 0.0f, "am");
-    m_Qa = createParam(m_gfmParameters.Qa.value(), 1.0f, 0.0f, "Qa");
+    m_Rd = defaults.Rd.createParamFrom();
+    m_Oq = createParam(defaults.Oq.value(), 1.0f, 0.0f, "Oq");
+    m_am = createParam(defaults.am.value(), 1.0f, 0.0f, "am");
+    m_Qa = createParam(defaults.Qa.value(), 1.0f, 0.0f, "Qa");
+}
+
+SourceGenerator::~SourceGenerator() {
+    for (SpeexResamplerState* decimator : m_decimators) {
+        if (decimator != nullptr) {
+            speex_resampler_destroy(decimator);
+        }
+    }
 }
 
 ScalarParameter& SourceGenerator::pitch() { return m_paramF0; }
@@ -73,6 +88,32 @@ ToggleParameter& SourceGenerator::jitterToggle() { return m_paramJitterToggle; }
 
 ToggleParameter& SourceGenerator::shimmerToggle() { return m_paramShimmerToggle; }
 
+int SourceGenerator::oversampling() const { return m_oversampling; }
+
+void SourceGenerator::setOversampling(const int factor) { m_oversampling = factor; }
+
+double SourceGenerator::costPerSample() const { return m_costPerSample; }
+
+void SourceGenerator::copyPeriodStartsTo(std::vector<double>& out) const {
+    const uint64_t count = m_periodCount.load(std::memory_order_acquire);
+    const uint64_t first = count - std::min<uint64_t>(count, kPeriodHistory);
+
+    out.resize(count - first);
+    for (uint64_t n = first; n < count; ++n) {
+        const auto& start = m_periodStarts[n % kPeriodHistory];
+        out[n - first] = start.load(std::memory_order_relaxed);
+    }
+
+    // The oldest entries may have been overwritten by newer periods while copying,
+    // which breaks the ordering. Drop everything up to the last break.
+    for (int i = int(out.size()) - 1; i > 0; --i) {
+        if (out[i - 1] >= out[i]) {
+            out.erase(out.begin(), std::next(out.begin(), i));
+            break;
+        }
+    }
+}
+
 void SourceGenerator::handleModelChanged(const GlottalFlowModelType type) {
     m_internalParamChanged = true;
 }
@@ -120,45 +161,64 @@ void SourceGenerator::handleParamChanged(const std::string& name, const Scalar v
 }
 
 void SourceGenerator::handleUsingRdChanged(const bool usingRd) {
-    m_gfmParameters.setUsingRd(usingRd);
+    m_usingRd = usingRd;
     m_internalParamChanged = true;
 }
 
 void SourceGenerator::fillInternalBuffer(std::vector<Scalar>& out) {
-    auto model = m_glottalFlow.genModel().lock();
-    if (!model) {
-        // genModel expired
-        return;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    if (hasSampleRateChanged() || m_oversampling != m_currentOversampling) {
+        m_currentOversampling = m_oversampling;
+        updateDecimator();
+        // Restart the period at the new rate.
+        m_phaseIncrement = 0;
     }
 
-    if (m_currentPeriod == 0) {
+    const int    factor = m_currentOversampling;
+    const Scalar internalFs = fs() * factor;
+
+    // Render straight into the output when not oversampling.
+    std::vector<Scalar>& buffer = (factor > 1) ? m_oversampledBuffer : out;
+    buffer.resize(out.size() * factor);
+
+    if (m_phaseIncrement == 0) {
         m_currentF0 = m_f0->valueForTime(time());
-        m_currentPeriod = std::round(fs() / m_currentF0);
-        m_currentTime = 0;
+        m_phaseIncrement = m_currentF0 / internalFs;
+        m_phase = 0;
         m_currentShimmer = 1;
-        // Init model
-        model->updateParameterBounds(m_gfmParameters);
-        model->fitParameters(m_gfmParameters);
-        m_cachedGfm.setPeriodLength(m_currentPeriod);
-        m_cachedGfm.updateCache(model.get());
+        markPeriodStart(0);
+        // Output is silent until the worker delivers the first table.
+        requestTableIfNeeded(time());
     }
 
-    for (int i = 0; i < out.size(); ++i) {
-        const Scalar t = time(i);
+    for (int i = 0; i < buffer.size(); ++i) {
+        const Scalar t = time(0) + i / internalFs;
 
         // Evaluate.
-        /*out[i] =
-            model->evaluate(1.0 - Scalar(m_currentTime) / Scalar(m_currentPeriod - 1));*/
-        out[i] = m_cachedGfm.get(m_currentTime) * m_currentShimmer;
+        buffer[i] = (m_currentTable != nullptr)
+                        ? m_currentTable->get(m_phase) * m_currentShimmer
+                        : 0;
+
+        m_phase += m_phaseIncrement;
 
-        ++m_currentTime;
+        if (m_phase >= 1) {
+            // Keep the fractional part so that f0 isn't rounded to whole samples.
+            m_phase -= 1;
 
-        if (m_currentTime >= m_currentPeriod) {
-            // Update parameters every period.
-            m_gfmParameters.Oq.setValue(m_Oq->valueForTime(t));
-            m_gfmParameters.am.setValue(m_am->valueForTime(t));
-            m_gfmParameters.Qa.setValue(m_Qa->valueForTime(t));
-            m_gfmParameters.Rd.setValue(m_Rd->valueForTime(t));
+            // The phase crossed 1 that far before sample i + 1.
+            markPeriodStart(i + 1 - m_phase / m_phaseIncrement);
+
+            // Update parameters every period, the model is rebuilt in the background.
+            requestTableIfNeeded(t);
+
+            // Switch to the most recent table at the period boundary.
+            if (auto table = m_tableWorker.takeLatest()) {
+                if (m_currentTable != nullptr) {
+                    m_tableWorker.retire(m_currentTable);
+                }
+                m_currentTable = table;
+            }
 
             m_currentF0 = m_f0->valueForTime(t);
 
@@ -174,38 +234,47 @@ void SourceGenerator::fillInternalBuffer(std::vector<Scalar>& out) {
                 jitterDistributionDeviations[m_jitterDistribution(m_randomGenerator)];
             m_currentF0 *= (1 + Jmax * Jn);
 
-            m_currentPeriod = std::round(fs() / m_currentF0);
-            m_currentTime = 0;
-            m_cachedGfm.setPeriodLength(m_currentPeriod);
+            m_phaseIncrement = m_currentF0 / internalFs;
 
             // Introduce shimmer.
             const Scalar Smax = m_Smax->valueForTime(t);
             const Scalar Sn =
                 jitterDistributionDeviations[m_jitterDistribution(m_randomGenerator)];
             m_currentShimmer = (1 + Smax * Sn);
-
-            // Rebuild model if needed.
-            if (m_internalParamChanged) {
-                m_internalParamChanged = false;
-                model->updateParameterBounds(m_gfmParameters);
-                model->fitParameters(m_gfmParameters);
-                m_cachedGfm.markModelChanged();
-            }
-
-            // Recache GFM values if needed.
-            if (m_cachedGfm.isDirty()) {
-                m_cachedGfm.updateCache(model.get());
-            }
         }
     }
 
     // Async filter creation
     if (hasSampleRateChanged()) {
+        RealtimeAudit::AllowScope allow;
         m_antialiasFilter.loPass(fs(), fs() / 2 - 1000, 1);
         ackSampleRateChange();
     }
 
-    out = m_antialiasFilter.filter(out);
+    if (factor > 1) {
+        // The decimator's lowpass replaces the antialiasing filter.
+        const int length = out.size();
+        m_decimatorInput.resize(buffer.size());
+        m_decimatorOutput.resize(length);
+        // Flush what would become float denormals (e.g. the tail of the LF return
+        // phase), they slow the decimator down by an order of magnitude.
+        std::transform(buffer.begin(), buffer.end(), m_decimatorInput.begin(),
+                       [](const Scalar x) {
+                           return std::abs(x) < 1e-30_f ? 0.0f : float(x);
+                       });
+
+        spx_uint32_t inLength = m_decimatorInput.size();
+        spx_uint32_t outLength = length;
+        speex_resampler_process_float(m_decimator, 0, m_decimatorInput.data(), &inLength,
+                                      m_decimatorOutput.data(), &outLength);
+
+        // The ratio is an integer so every input block yields exactly one output block.
+        std::copy(m_decimatorOutput.begin(),
+                  std::next(m_decimatorOutput.begin(), outLength), out.begin());
+        std::fill(std::next(out.begin(), outLength), out.end(), 0.0_f);
+    } else {
+        m_antialiasFilter.process(out.data(), out.size());
+    }
 
     // Prune past parameter events
     m_Oq->pruneEventsPriorToTime(time());
@@ -216,8 +285,83 @@ void SourceGenerator::fillInternalBuffer(std::vector<Scalar>& out) {
     m_Fpmax->pruneEventsPriorToTime(time());
     m_Jmax->pruneEventsPriorToTime(time());
     m_Smax->pruneEventsPriorToTime(time());
+
+    const auto   endTime = std::chrono::steady_clock::now();
+    const double elapsedNs =
+        std::chrono::duration<double, std::nano>(endTime - startTime).count();
+    const double cost = elapsedNs / out.size();
+    // Exponential moving average over roughly the last 20 blocks.
+    m_costPerSample = m_costPerSample + 0.05 * (cost - m_costPerSample);
 }
 
-void SourceGenerator::handleInternalParamChanged(const std::string&, Scalar) {
-    m_internalParamChanged = true;
+void SourceGenerator::prepareInternalBuffer(const int maxBlockSize) {
+    m_oversampledBuffer.reserve(maxBlockSize * kMaxOversampling);
+    m_decimatorInput.reserve(maxBlockSize * kMaxOversampling);
+    m_decimatorOutput.reserve(maxBlockSize);
+
+    // The filter only depends on the ratio, not on fs, so the decimators are built
+    // once for every factor here rather than on the audio thread when it changes.
+    for (int factor = 2; factor <= kMaxOversampling; factor *= 2) {
+        if (m_decimators[factor] == nullptr) {
+            int err;
+            m_decimators[factor] = speex_resampler_init(
+                1, factor, 1, SPEEX_RESAMPLER_QUALITY_DESKTOP, &err);
+        }
+    }
+}
+
+void SourceGenerator::requestTableIfNeeded(const Scalar t) {
+    GlottalFlowTableWorker::Request request;
+    request.usingRd = m_usingRd;
+    request.Oq = m_Oq->valueForTime(t);
+    request.am = m_am->valueForTime(t);
+    request.Qa = m_Qa->valueForTime(t);
+    request.Rd = m_Rd->valueForTime(t);
+
+    // With Rd, Oq/am/Qa are outputs of the fit.
+    const auto& last = m_lastTableRequest;
+    const bool  isChanged =
+        (request.usingRd != last.usingRd) ||
+        (request.usingRd ? !fuzzyEquals(request.Rd, last.Rd)
+                         : !fuzzyEquals(request.Oq, last.Oq) ||
+                               !fuzzyEquals(request.am, last.am) ||
+                               !fuzzyEquals(request.Qa, last.Qa));
+
+    if (m_internalParamChanged.exchange(false) || isChanged) {
+        if (m_tableWorker.request(request)) {
+            m_lastTableRequest = request;
+        } else {
+            // Queue is full, try again next period.
+            m_internalParamChanged = true;
+        }
+    }
+}
+
+void SourceGenerator::markPeriodStart(const double position) {
+    // Delays between the rendered block and the output: decimation, then the
+    // compressor in BufferedGenerator.
+    const double start = timeSamples(0) + position / m_currentOversampling +
+                         m_decimatorLatency + outputDelay();
+
+    const uint64_t count = m_periodCount.load(std::memory_order_relaxed);
+    m_periodStarts[count % kPeriodHistory].store(start, std::memory_order_relaxed);
+    m_periodCount.store(count + 1, std::memory_order_release);
+}
+
+void SourceGenerator::updateDecimator() {
+    m_decimator = nullptr;
+    m_decimatorLatency = 0;
+
+    if (m_currentOversampling > 1) {
+        m_decimator = m_decimators[m_currentOversampling];
+        if (m_decimator == nullptr) {
+            // Fall back to rendering at the output rate.
+            m_oversampling = 1;
+            m_currentOversampling = 1;
+        } else {
+            // Start from silence, like a new decimator.
+            speex_resampler_reset_mem(m_decimator);
+            m_decimatorLatency = speex_resampler_get_output_latency(m_decimator);
+        }
+    }
 }
@@ -2,13 +2,17 @@
 #define SOURCEMODEL__SOURCE_GENERATOR_H
 
 #include <NFParam/Param.h>
+#include <speex_resampler.h>
 
+#include <array>
 #include <atomic>
 #include <random>
+#include <vector>
 
 #include "CachedGlottalFlowModel.h"
 #include "GlottalFlowModel.h"
 #include "GlottalFlowParameters.h"
+#include "GlottalFlowTableWorker.h"
 #include "ToggleParameter.h"
 #include "audio/BufferedGenerator.h"
 #include "audio/LookAheadGainReduction.h"
@@ -22,6 +26,7 @@ class GlottalFlow;
 class SourceGenerator : public BufferedGenerator {
    public:
     SourceGenerator(const AudioTime& time, GlottalFlow& glottalFlow);
+    ~SourceGenerator();
 
     ScalarParameter& pitch();
     ScalarParameter& flutter();
@@ -32,21 +37,44 @@ class SourceGenerator : public BufferedGenerator {
     ToggleParameter& jitterToggle();
     ToggleParameter& shimmerToggle();
 
+    // The source is rendered at factor * fs then decimated (1, 2, 4 or 8).
+    static constexpr int kMaxOversampling = 8;
+
+    int  oversampling() const;
+    void setOversampling(int factor);
+
+    // Average time spent rendering one output sample, in nanoseconds.
+    double costPerSample() const;
+
+    static constexpr int kPeriodHistory = 64;
+
+    // Starts of the last periods (at most kPeriodHistory) in the output, oldest first,
+    // in samples since the clock started. They are fractional, f0 isn't rounded to
+    // whole samples. Safe to call from any thread.
+    void copyPeriodStartsTo(std::vector<double>& out) const;
+
     void handleModelChanged(GlottalFlowModelType type);
     void handleParamChanged(const std::string& name, Scalar value);
     void handleUsingRdChanged(bool usingRd);
 
    protected:
     void fillInternalBuffer(std::vector<Scalar>& out) override;
+    void prepareInternalBuffer(int maxBlockSize) override;
 
    private:
-    void handleInternalParamChanged(const std::string&, Scalar);
+    void requestTableIfNeeded(Scalar t);
+    void updateDecimator();
+
+    // Audio thread. position is in samples of the current (oversampled) block.
+    void markPeriodStart(double position);
 
     GlottalFlow& m_glottalFlow;
 
-    // GFM instance to handle bound checking and such.
-    GlottalFlowParameters  m_gfmParameters;
-    CachedGlottalFlowModel m_cachedGfm;
+    // Model fitting and table building happen on the worker thread.
+    GlottalFlowTableWorker          m_tableWorker;
+    GlottalFlowTableWorker::Request m_lastTableRequest;
+    CachedGlottalFlowModel*         m_currentTable;
+    std::atomic_bool                m_usingRd;
 
     // NFParam for each parameter.
     std::shared_ptr<nativeformat::param::Param> m_Oq;
@@ -73,14 +101,30 @@ class SourceGenerator : public BufferedGenerator {
     std::discrete_distribution<int> m_jitterDistribution;
 
     Scalar m_currentF0;
-    int    m_currentPeriod;
-    int    m_currentTime;
+    Scalar m_phase;           // Position in the current period, in [0, 1).
+    Scalar m_phaseIncrement;  // f0 / fs, 0 until the first period starts.
     Scalar m_currentShimmer;
 
-    Scalar           m_gfmTime;
     std::atomic_bool m_internalParamChanged;
 
+    // Ring of period starts, written by the audio thread only.
+    std::array<std::atomic<double>, kPeriodHistory> m_periodStarts;
+    std::atomic_uint64_t                            m_periodCount;
+
     Butterworth m_antialiasFilter;
+
+    std::atomic_int      m_oversampling;
+    int                  m_currentOversampling;
+    SpeexResamplerState* m_decimator;         // One of m_decimators, null at 1x.
+    int                  m_decimatorLatency;  // In output samples.
+    std::vector<Scalar>  m_oversampledBuffer;
+    std::vector<float>   m_decimatorInput;
+    std::vector<float>   m_decimatorOutput;
+
+    // Indexed by factor, built by prepareInternalBuffer so switching never allocates.
+    std::array<SpeexResamplerState*, kMaxOversampling + 1> m_decimators;
+
+    std::atomic<double> m_costPerSample;
 };
 
 #endif  // SOURCEMODEL__SOURCE_GENERATOR_H
\ No newline at end of file
@@ -3,9 +3,11 @@
 #include <implot_internal.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <iostream>
 
+#include "audio/RealtimeAudit.h"
 #include "math/LTTB.h"
 #include "math/utils.h"
 
@@ -20,6 +22,13 @@ SourceModelApp::SourceModelApp(const int initialWidth, const int initialHeight)
       m_sourceSpectrum(&m_sourceGenerator),
       m_formantGenerator(m_audioOutput, m_intermediateAudioBuffer),
       m_formantSpectrum(&m_formantGenerator),
+      m_showSpectrogram(false),
+      m_sourceConstantQ(&m_sourceGenerator),
+      m_formantConstantQ(&m_formantGenerator),
+      m_useConstantQ(false),
+      m_sourceHarmonics(&m_sourceGenerator, &m_sourceGenerator),
+      m_formantHarmonics(&m_sourceGenerator, &m_formantGenerator),
+      m_showHarmonics(false),
       m_downsampledCount(0),
       m_downsampledStart(-1),
       m_downsampledEnd(-1),
@@ -36,19 +45,24 @@ SourceModelApp::SourceModelApp(const int initialWidth, const int initialHeight)
       m_linVolume(0.6561) {
     ImPlot::CreateContext();
 
-    m_audioOutput.setBufferCallback([this](std::vector<Scalar>& out) {
-        m_intermediateAudioBuffer.resize(out.size());
+    m_audioOutput.setBufferCallback([this](AudioBlock& block) {
+        m_intermediateAudioBuffer.resize(block.length);
+        m_filteredAudioBuffer.resize(block.length);
         m_sourceGenerator.fillBuffer(m_intermediateAudioBuffer);
+        m_formantGenerator.fillBuffer(m_filteredAudioBuffer);
+
+        // The output applies the gains as it writes the device buffer. Compensate gain
+        // (the source is usually *perceived* louder so lower it)
+        const Scalar sourceGain = 0.25_f * m_linVolume;
+        block.aux = &m_intermediateAudioBuffer;
+        block.auxGain = sourceGain;
         if (m_doBypassFilter) {
-            std::copy(m_intermediateAudioBuffer.begin(), m_intermediateAudioBuffer.end(),
-                      out.begin());
-            m_formantGenerator.fillBuffer(m_intermediateAudioBuffer);
-            // Compensate gain (the source is usually *perceived* louder so lower it)
-            for (auto& x : out) x *= 0.25_f;
+            block.main = &m_intermediateAudioBuffer;
+            block.mainGain = sourceGain;
         } else {
-            m_formantGenerator.fillBuffer(out);
+            block.main = &m_filteredAudioBuffer;
+            block.mainGain = m_linVolume;
         }
-        for (auto& x : out) x *= m_linVolume;
         return true;
     });
 
@@ -60,19 +74,25 @@ SourceModelApp::SourceModelApp(const int initialWidth, const int initialHeight)
 
     m_sourceSpectrum.setTransformSize(4096);
     m_formantSpectrum.setTransformSize(4096);
+    m_sourceSpectrum.setWorker(&m_spectrumWorker);
+    m_formantSpectrum.setWorker(&m_spectrumWorker);
     m_formantGenerator.spectrum().setSize(4096);
 
+    m_formantGenerator.setSpectrogram(&m_spectrogram);
+
     m_sourceGenerator.setNormalized(true);
     m_formantGenerator.setNormalized(false);
 
+    // Nothing in the audio callback allocates after this.
+    m_intermediateAudioBuffer.reserve(AudioOutput::kMaxBlockSize);
+    m_filteredAudioBuffer.reserve(AudioOutput::kMaxBlockSize);
+    m_sourceGenerator.prepare(AudioOutput::kMaxBlockSize);
+    m_formantGenerator.prepare(AudioOutput::kMaxBlockSize);
+
 #ifdef USING_RTAUDIO
     setAudioOutputDevice(m_audioDevices.defaultOutputDevice());
 #else
-    m_sourceGenerator.setSampleRate(m_audioOutput.sampleRate());
-    m_sourceSpectrum.setSampleRate(m_audioOutput.sampleRate());
-    m_formantGenerator.setSampleRate(m_audioOutput.sampleRate());
-    m_formantSpectrum.setSampleRate(m_audioOutput.sampleRate());
-    m_formantGenerator.spectrum().setSampleRate(m_audioOutput.sampleRate());
+    updateSampleRate();
 #endif
 
     m_glottalFlow.parameters().Oq.valueChanged.connect(
@@ -90,7 +110,10 @@ SourceModelApp::SourceModelApp(const int initialWidth, const int initialHeight)
                                            &m_sourceGenerator);
 }
 
-SourceModelApp::~SourceModelApp() { ImPlot::DestroyContext(); }
+SourceModelApp::~SourceModelApp() {
+    m_formantGenerator.setSpectrogram(nullptr);
+    ImPlot::DestroyContext();
+}
 
 void SourceModelApp::setupThemeColors(ImGuiStyle& style) {
     if (isDarkTheme()) {
@@ -197,14 +220,196 @@ void SourceModelApp::renderMenuBar() {
 #endif
 
         char line[64];
-        snprintf(line, 64, "Sample rate: %d Hz", (int)m_audioOutput.sampleRate());
+        snprintf(line, 64, "Sample rate: %d Hz", (int)m_audioOutput.deviceSampleRate());
+        ImGui::MenuItem(line, nullptr, false, false);
+
+#ifdef USING_RTAUDIO
+        // Synthesis costs the same on every device at a fixed rate, and the DSP sounds
+        // the same.
+        if (ImGui::BeginMenu("Synthesis rate")) {
+            for (const int rate : {0, 44100, 48000, 96000}) {
+                if (rate == 0) {
+                    snprintf(line, 64, "Device rate");
+                } else {
+                    snprintf(line, 64, "%d Hz", rate);
+                }
+                const bool isSelected = (m_audioOutput.renderSampleRate() == rate);
+                if (ImGui::MenuItem(line, nullptr, isSelected) && !isSelected) {
+                    m_audioOutput.setRenderSampleRate(rate);
+                    updateSampleRate();
+                }
+            }
+            ImGui::EndMenu();
+        }
+        if (m_audioOutput.isResampling()) {
+            snprintf(line, 64, "Resampling from %d Hz", (int)m_audioOutput.sampleRate());
+            ImGui::MenuItem(line, nullptr, false, false);
+        }
+#endif
+
+        if (ImGui::BeginMenu("Buffer size")) {
+            for (int frames = 64; frames <= AudioOutput::kMaxBlockSize; frames *= 2) {
+                snprintf(line, 64, "%d samples (%.1f ms)", frames,
+                         1000 * frames / m_audioOutput.deviceSampleRate());
+                const bool isSelected = (m_audioOutput.bufferSize() == frames);
+                if (ImGui::MenuItem(line, nullptr, isSelected) && !isSelected) {
+                    m_audioOutput.setBufferSize(frames);
+                }
+            }
+            ImGui::EndMenu();
+        }
+
+#ifdef USING_RTAUDIO
+        if (ImGui::BeginMenu("Number of buffers")) {
+            for (const int count : {0, 2, 3, 4}) {
+                if (count == 0) {
+                    snprintf(line, 64, "Default");
+                } else {
+                    snprintf(line, 64, "%d", count);
+                }
+                const bool isSelected = (m_audioOutput.numberOfBuffers() == count);
+                if (ImGui::MenuItem(line, nullptr, isSelected) && !isSelected) {
+                    m_audioOutput.setNumberOfBuffers(count);
+                }
+            }
+            ImGui::EndMenu();
+        }
+
+        bool minimizeLatency = m_audioOutput.minimizeLatency();
+        if (ImGui::MenuItem("Minimize latency", nullptr, &minimizeLatency)) {
+            m_audioOutput.setMinimizeLatency(minimizeLatency);
+        }
+
+        // Splitting needs a second channel.
+        const bool canSplit = (m_selectedAudioOutputDevice.outputChannels > 1);
+        if (ImGui::BeginMenu("Channel routing", canSplit)) {
+            const AudioRouting routing = m_audioOutput.routing();
+            if (ImGui::MenuItem("Same on every channel", nullptr,
+                                routing == AudioRouting_Mono) &&
+                routing != AudioRouting_Mono) {
+                m_audioOutput.setRouting(AudioRouting_Mono);
+            }
+            if (ImGui::MenuItem("Source on 1, output on 2", nullptr,
+                                routing == AudioRouting_Split) &&
+                routing != AudioRouting_Split) {
+                m_audioOutput.setRouting(AudioRouting_Split);
+            }
+            ImGui::EndMenu();
+        }
+#endif
+
+        if (m_audioOutput.streamBufferSize() > 0) {
+            snprintf(line, 64, "Output latency: %s%.1f ms (%d-sample buffer)",
+                     m_audioOutput.isLatencyReported() ? "" : "~",
+                     1000 * m_audioOutput.latency(), m_audioOutput.streamBufferSize());
+            ImGui::MenuItem(line, nullptr, false, false);
+        }
+
+        ImGui::Separator();
+
+        if (ImGui::BeginMenu("Source oversampling")) {
+            for (int factor = 1; factor <= 8; factor *= 2) {
+                snprintf(line, 64, "%dx", factor);
+                const bool isSelected = (m_sourceGenerator.oversampling() == factor);
+                if (ImGui::MenuItem(line, nullptr, isSelected) && !isSelected) {
+                    m_sourceGenerator.setOversampling(factor);
+                }
+            }
+            ImGui::EndMenu();
+        }
+
+        snprintf(line, 64, "Source cost: %.0f ns/sample",
+                 m_sourceGenerator.costPerSample());
         ImGui::MenuItem(line, nullptr, false, false);
+
+        if (ImGui::BeginMenu("Formant control rate")) {
+            for (const int period : {1, 16, 32, 64}) {
+                if (period == 1) {
+                    snprintf(line, 64, "Every sample");
+                } else {
+                    snprintf(line, 64, "Every %d samples", period);
+                }
+                const bool isSelected = (m_formantGenerator.controlPeriod() == period);
+                if (ImGui::MenuItem(line, nullptr, isSelected) && !isSelected) {
+                    m_formantGenerator.setControlPeriod(period);
+                }
+            }
+            ImGui::EndMenu();
+        }
         ImGui::EndMenu();
     }
 
     ImGui::Separator();
 }
 
+void SourceModelApp::renderDebugMenu() {
+    if (ImGui::BeginMenu("Audio load")) {
+        char line[64];
+
+        const auto callback = m_audioOutput.callbackLoad().statistics();
+        renderLoadStatistics("Callback", callback);
+
+        // Share of the callbacks in each 10% bin, the last one is overload.
+        std::array<float, LoadMeter::kHistogramBins> histogram;
+        for (int i = 0; i < LoadMeter::kHistogramBins; ++i) {
+            histogram[i] = callback.blocks > 0
+                               ? float(callback.histogram[i]) / callback.blocks
+                               : 0.0f;
+        }
+        ImGui::PlotHistogram("##callbackLoad", histogram.data(), histogram.size(), 0,
+                             "0-100%, overload", 0.0f, 1.0f, ImVec2(15 * em(), 4 * em()));
+
+        ImGui::Separator();
+
+        renderLoadStatistics("Source", m_sourceGenerator.generatorLoad().statistics());
+        renderLoadStatistics("Source gain reduction",
+                             m_sourceGenerator.gainReductionLoad().statistics());
+        renderLoadStatistics("Formants", m_formantGenerator.generatorLoad().statistics());
+        renderLoadStatistics("Formant gain reduction",
+                             m_formantGenerator.gainReductionLoad().statistics());
+
+        ImGui::Separator();
+
+        snprintf(line, 64, "Underflows: %llu",
+                 (unsigned long long)m_audioOutput.underflowCount());
+        ImGui::MenuItem(line, nullptr, false, false);
+        snprintf(line, 64, "Overflows: %llu",
+                 (unsigned long long)m_audioOutput.overflowCount());
+        ImGui::MenuItem(line, nullptr, false, false);
+
+        if (RealtimeAudit::kEnabled) {
+            const auto counts = RealtimeAudit::counts();
+            snprintf(line, 64, "Audio thread: %llu allocs, %llu frees, %llu locks",
+                     (unsigned long long)counts.allocations,
+                     (unsigned long long)counts.deallocations,
+                     (unsigned long long)counts.locks);
+            ImGui::MenuItem(line, nullptr, false, false);
+        }
+
+        ImGui::Separator();
+
+        if (ImGui::MenuItem("Reset")) {
+            m_audioOutput.callbackLoad().reset();
+            m_audioOutput.resetXrunCounts();
+            m_sourceGenerator.generatorLoad().reset();
+            m_sourceGenerator.gainReductionLoad().reset();
+            m_formantGenerator.generatorLoad().reset();
+            m_formantGenerator.gainReductionLoad().reset();
+            RealtimeAudit::resetCounts();
+        }
+
+        ImGui::EndMenu();
+    }
+}
+
+void SourceModelApp::renderLoadStatistics(const char*                  name,
+                                          const LoadMeter::Statistics& statistics) {
+    char line[64];
+    snprintf(line, 64, "%s: %.1f%% (peak %.1f%%)", name, 100 * statistics.averageLoad,
+             100 * statistics.peakLoad);
+    ImGui::MenuItem(line, nullptr, false, false);
+}
+
 void SourceModelApp::renderMain() {
     if (m_glottalFlow.isDirty()) {
         m_glottalFlow.updateSamples();
@@ -395,6 +600,8 @@ void SourceModelApp::renderMain() {
 
     if (!m_formantGenerator.flutterToggle().value()) ImGui::EndDisabled();
 
+    ToggleParameterControl(m_formantGenerator.parallelToggle(), "Parallel formants");
+
     if (m_doBypassFilter) ImGui::EndDisabled();
 
     ImGui::EndGroupPanel();  // Filter
@@ -411,8 +618,11 @@ void SourceModelApp::renderMain() {
 
     const float spectrumPlotHeight = ImGui::GetContentRegionAvail().y - 0.5f * em();
 
-    if (ImPlot::BeginPlot("##specplot", ImVec2(spectrumPlotWidth, spectrumPlotHeight),
-                          ImPlotFlags_NoFrame)) {
+    if (m_showSpectrogram) {
+        renderSpectrogram(spectrumPlotWidth, spectrumPlotHeight);
+    } else if (ImPlot::BeginPlot("##specplot",
+                                 ImVec2(spectrumPlotWidth, spectrumPlotHeight),
+                                 ImPlotFlags_NoFrame)) {
         ImPlot::SetupAxis(ImAxis_X1, "Frequency [Hz]", ImPlotAxisFlags_None);
         ImPlot::SetupAxisLimitsConstraints(ImAxis_X1, 8, m_audioOutput.sampleRate() / 2);
         ImPlot::SetupAxisLimits(ImAxis_X1, 60, 8000);
@@ -430,15 +640,29 @@ void SourceModelApp::renderMain() {
 
         ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 2.0f * contentScale());
 
-        ImPlot::PlotLine("Glottal source", m_sourceSpectrum.frequencies(),
-                         m_sourceSpectrum.magnitudesDb(), m_sourceSpectrum.binCount());
+        if (m_useConstantQ) {
+            ImPlot::PlotLine("Glottal source", m_sourceConstantQ.frequencies(),
+                             m_sourceConstantQ.magnitudesDb(),
+                             m_sourceConstantQ.binCount());
+        } else {
+            ImPlot::PlotLine("Glottal source", m_sourceSpectrum.frequencies(),
+                             m_sourceSpectrum.magnitudesDb(),
+                             m_sourceSpectrum.binCount());
+        }
 
         ImPlot::PopStyleVar(ImPlotStyleVar_LineWeight);
 
         ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 2.0f * contentScale());
 
-        ImPlot::PlotLine("Filtered source", m_formantSpectrum.frequencies(),
-                         m_formantSpectrum.magnitudesDb(), m_formantSpectrum.binCount());
+        if (m_useConstantQ) {
+            ImPlot::PlotLine("Filtered source", m_formantConstantQ.frequencies(),
+                             m_formantConstantQ.magnitudesDb(),
+                             m_formantConstantQ.binCount());
+        } else {
+            ImPlot::PlotLine("Filtered source", m_formantSpectrum.frequencies(),
+                             m_formantSpectrum.magnitudesDb(),
+                             m_formantSpectrum.binCount());
+        }
 
         ImPlot::PopStyleVar(ImPlotStyleVar_LineWeight);
 
@@ -450,6 +674,21 @@ void SourceModelApp::renderMain() {
 
         ImPlot::PopStyleVar(ImPlotStyleVar_LineWeight);
 
+        if (m_showHarmonics) {
+            // Stems from the bottom of the plot, in the colors of their spectrum.
+            constexpr double stemBase = -150;
+
+            ImPlot::SetNextLineStyle(ImPlot::GetColormapColor(0));
+            ImPlot::PlotStems("##sourceharmonics", m_sourceHarmonics.frequencies(),
+                              m_sourceHarmonics.magnitudesDb(),
+                              m_sourceHarmonics.harmonicCount(), stemBase);
+
+            ImPlot::SetNextLineStyle(ImPlot::GetColormapColor(1));
+            ImPlot::PlotStems("##formantharmonics", m_formantHarmonics.frequencies(),
+                              m_formantHarmonics.magnitudesDb(),
+                              m_formantHarmonics.harmonicCount(), stemBase);
+        }
+
         ImPlot::EndPlot();  // ##specplot
     }
 
@@ -485,13 +724,107 @@ void SourceModelApp::renderMain() {
         ImGui::EndCombo();
     }
 
+    ImGui::Checkbox("Constant-Q", &m_useConstantQ);
+    if (m_useConstantQ && ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("%d bands, %.0f ms behind", m_formantConstantQ.bandCount(),
+                          1000 * m_formantConstantQ.latency());
+    }
+
+    ImGui::Checkbox("Harmonics", &m_showHarmonics);
+
+    if (m_showHarmonics && m_sourceHarmonics.f0() > 0) {
+        ImGui::Text("f0 %.1f Hz", m_sourceHarmonics.f0());
+        ImGui::Text("H1-H2 %.1f dB", m_sourceHarmonics.h1h2());
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Of the glottal source");
+        }
+        ImGui::Text("H1-A3 %.1f dB", m_formantHarmonics.h1a3());
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Of the filtered source, A3 is the harmonic closest to F3");
+        }
+    }
+
+    ImGui::Checkbox("Spectrogram", &m_showSpectrogram);
+
+    if (m_showSpectrogram) {
+        // Overlap of successive frames, as a fraction of the frame length.
+        static constexpr std::array<int, 3> kOverlaps = {2, 4, 8};
+
+        const int spectrogramNfft = m_spectrogram.transformSize();
+        const int overlap = spectrogramNfft / m_spectrogram.hop();
+
+        ImGui::SetNextItemWidth(10 * em());
+        if (ImGui::BeginCombo("Overlap",
+                              std::to_string(100 - 100 / overlap).append("%").c_str())) {
+            for (const int k : kOverlaps) {
+                const std::string label = std::to_string(100 - 100 / k).append("%");
+                if (ImGui::Selectable(label.c_str(), k == overlap)) {
+                    m_spectrogram.setLayout(spectrogramNfft, spectrogramNfft / k,
+                                            m_spectrogram.frameCount());
+                }
+            }
+            ImGui::EndCombo();
+        }
+    }
+
     ImGui::EndGroupPanel();  // Spectrum settings
 
     ImGui::EndChild();  // ContainerBottom
 
-    m_sourceSpectrum.update();
-    m_formantSpectrum.update();
+    if (m_useConstantQ) {
+        m_sourceConstantQ.setFrequencyScale(m_spectrumFrequencyScale);
+        m_formantConstantQ.setFrequencyScale(m_spectrumFrequencyScale);
+        m_sourceConstantQ.update();
+        m_formantConstantQ.update();
+    } else {
+        // Picks up what the worker finished since the last frame.
+        m_spectrumWorker.requestUpdate();
+        m_sourceSpectrum.update();
+        m_formantSpectrum.update();
+    }
+    if (m_showHarmonics) {
+        m_formantHarmonics.setThirdFormant(m_formantGenerator.frequency(2).value());
+        m_sourceHarmonics.update();
+        m_formantHarmonics.update();
+    }
     m_formantGenerator.updateSpectrumIfNeeded();
+    m_spectrogram.update();
+}
+
+void SourceModelApp::renderSpectrogram(const float width, const float height) {
+    // Only the bins up to here are drawn, one rectangle per bin and frame.
+    constexpr Scalar maxFrequency = 8000;
+
+    const Scalar fs = m_spectrogram.sampleRate();
+    const Scalar binWidth = fs / m_spectrogram.transformSize();
+    const int    binCount = std::min<int>(m_spectrogram.binCount(),
+                                          std::ceil(maxFrequency / binWidth) + 1);
+
+    const int    frameCount = m_spectrogram.copyTo(m_spectrogramImage, binCount);
+    const Scalar duration = frameCount * m_spectrogram.hop() / fs;
+
+    if (ImPlot::BeginPlot("##spectrogram", ImVec2(width, height), ImPlotFlags_NoFrame)) {
+        ImPlot::SetupAxis(ImAxis_X1, "Frequency [Hz]", ImPlotAxisFlags_None);
+        ImPlot::SetupAxisLimitsConstraints(ImAxis_X1, 8, binCount * binWidth);
+        ImPlot::SetupAxisLimits(ImAxis_X1, 60, maxFrequency);
+
+        ImPlot::SetupAxisScale(ImAxis_X1, FrequencyScale_TransformFwd,
+                               FrequencyScale_TransformInv, &m_spectrumFrequencyScale);
+
+        ImPlot::SetupAxis(ImAxis_Y1, "Time [s]", ImPlotAxisFlags_None);
+        ImPlot::SetupAxisLimits(ImAxis_Y1, -duration, 0, ImPlotCond_Always);
+
+        setupPlotFrequencyTicks();
+
+        // Newest frame on the first row, at the top.
+        ImPlot::PushColormap(ImPlotColormap_Viridis);
+        ImPlot::PlotHeatmap("##levels", m_spectrogramImage.data(), frameCount, binCount,
+                            -90, 0, nullptr, ImPlotPoint(0, -duration),
+                            ImPlotPoint(binCount * binWidth, 0));
+        ImPlot::PopColormap();
+
+        ImPlot::EndPlot();  // ##spectrogram
+    }
 }
 
 void SourceModelApp::renderOther() {}
@@ -947,15 +1280,25 @@ void SourceModelApp::renderMessages() {
     }
 }
 
+void SourceModelApp::updateSampleRate() {
+    const Scalar fs = m_audioOutput.sampleRate();
+    m_sourceGenerator.setSampleRate(fs);
+    m_sourceSpectrum.setSampleRate(fs);
+    m_formantGenerator.setSampleRate(fs);
+    m_formantSpectrum.setSampleRate(fs);
+    m_formantGenerator.spectrum().setSampleRate(fs);
+    m_spectrogram.setSampleRate(fs);
+    m_sourceConstantQ.setSampleRate(fs);
+    m_formantConstantQ.setSampleRate(fs);
+    m_sourceHarmonics.setSampleRate(fs);
+    m_formantHarmonics.setSampleRate(fs);
+}
+
 #ifdef USING_RTAUDIO
 void SourceModelApp::setAudioOutputDevice(const RtAudio::DeviceInfo& deviceInfo) {
     m_selectedAudioOutputDevice = deviceInfo;
-    m_sourceGenerator.setSampleRate(m_audioOutput.sampleRate());
-    m_sourceSpectrum.setSampleRate(m_audioOutput.sampleRate());
-    m_formantGenerator.setSampleRate(m_audioOutput.sampleRate());
-    m_formantSpectrum.setSampleRate(m_audioOutput.sampleRate());
-    m_formantGenerator.spectrum().setSampleRate(m_audioOutput.sampleRate());
     m_audioOutput.setDevice(deviceInfo);
+    updateSampleRate();
 }
 
 void SourceModelApp::audioErrorCallback(RtAudioErrorType   type,
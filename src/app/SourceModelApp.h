@@ -6,10 +6,14 @@
 #endif
 
 #include "Application.h"
+#include "ConstantQSpectrum.h"
 #include "FormantGenerator.h"
 #include "GeneratorSpectrum.h"
 #include "GlottalFlow.h"
+#include "HarmonicSpectrum.h"
 #include "SourceGenerator.h"
+#include "Spectrogram.h"
+#include "SpectrumWorker.h"
 #include "math/FrequencyScale.h"
 
 #ifdef USING_RTAUDIO
@@ -39,6 +43,7 @@ class SourceModelApp : public Application {
     void renderMenuBar() override;
     void renderMain() override;
     void renderOther() override;
+    void renderDebugMenu() override;
 
    private:
     void SourceParameterControl(ScalarParameter& param, const char* name,
@@ -59,6 +64,11 @@ class SourceModelApp : public Application {
                         const char* format, bool autoScale = true,
                         int manualPrecision = 1);
 
+    // Waterfall of the filtered output, in place of the spectrum plot.
+    void renderSpectrogram(float width, float height);
+
+    void renderLoadStatistics(const char* name, const LoadMeter::Statistics& statistics);
+
     void updateDownscaledPlot(int count, int start, int end);
     void setupPlotFrequencyTicks();
     void setupPlotFrequencyTicksLinear(const ImPlotAxis& axis);
@@ -67,6 +77,9 @@ class SourceModelApp : public Application {
     bool canInsertLabel(double value, const char* label, const ImPlotAxis& axis,
                         const float pixelMin, const float pixelMax);
 
+    // Passes the output's sampleRate() on to the generators and analyses.
+    void updateSampleRate();
+
 #ifdef USING_RTAUDIO
     void setAudioOutputDevice(const RtAudio::DeviceInfo& deviceInfo);
 
@@ -92,13 +105,31 @@ class SourceModelApp : public Application {
     bool                     m_doOpenPopupNextFrame;
     std::vector<std::string> m_messages;
 
+    // Runs the FFT spectra, declared first so that it outlives them.
+    SpectrumWorker m_spectrumWorker;
+
     GlottalFlow       m_glottalFlow;
     SourceGenerator   m_sourceGenerator;
     GeneratorSpectrum m_sourceSpectrum;
 
     FormantGenerator    m_formantGenerator;
     GeneratorSpectrum   m_formantSpectrum;
-    std::vector<Scalar> m_intermediateAudioBuffer;
+    std::vector<Scalar> m_intermediateAudioBuffer;  // Source, input of the formants.
+    std::vector<Scalar> m_filteredAudioBuffer;
+
+    Spectrogram         m_spectrogram;
+    std::vector<Scalar> m_spectrogramImage;
+    bool                m_showSpectrogram;
+
+    // Constant-Q analysis in place of the FFT for the source and filtered spectra.
+    ConstantQSpectrum m_sourceConstantQ;
+    ConstantQSpectrum m_formantConstantQ;
+    bool              m_useConstantQ;
+
+    // Levels at the harmonics of f0, over the source and filtered spectra.
+    HarmonicSpectrum m_sourceHarmonics;
+    HarmonicSpectrum m_formantHarmonics;
+    bool             m_showHarmonics;
 
     int                   m_downsampledCount;
     int                   m_downsampledStart;
@@ -0,0 +1,159 @@
+#include "Spectrogram.h"
+
+#include <algorithm>
+#include <limits>
+#include <system_error>
+
+#include "math/VectorMath.h"
+#include "math/windows.h"
+
+Spectrogram::Spectrogram(const int nfft, const int hop, const int frameCount)
+    : m_nfft(0),
+      m_hop(0),
+      m_frameCount(0),
+      m_binCount(0),
+      m_fs(48000),
+      m_inputLength(0),
+      m_nextFrame(0),
+      m_queue(kQueueCapacity),
+      m_droppedSamples(0),
+      m_wakeups(0),
+      m_stop(false),
+      m_isSynchronous(false) {
+    m_chunk.resize(kQueueCapacity);
+    setLayout(nfft, hop, frameCount);
+
+    try {
+        m_thread = std::thread(&Spectrogram::run, this);
+    } catch (const std::system_error&) {
+        m_isSynchronous = true;
+    }
+}
+
+Spectrogram::~Spectrogram() {
+    if (m_thread.joinable()) {
+        m_stop = true;
+        m_wakeups.fetch_add(1);
+        m_wakeups.notify_one();
+        m_thread.join();
+    }
+}
+
+int Spectrogram::transformSize() const { return m_nfft; }
+
+int Spectrogram::hop() const { return m_hop; }
+
+int Spectrogram::frameCount() const { return m_frameCount; }
+
+int Spectrogram::binCount() const { return m_binCount; }
+
+void Spectrogram::setLayout(const int nfft, const int hop, const int frameCount) {
+    std::lock_guard lock(m_mutex);
+
+    if (nfft != m_nfft) {
+        m_nfft = nfft;
+        m_binCount = nfft / 2 + 1;
+        m_dtft.setSampleCount(nfft);
+        m_window = windows::blackmanHarris<Scalar>(nfft, false);
+        m_input.resize(nfft);
+        m_windowed.resize(nfft);
+    }
+    m_hop = std::clamp(hop, 1, nfft);
+    m_frameCount = frameCount;
+
+    m_frames.assign(m_frameCount * m_binCount, -std::numeric_limits<Scalar>::infinity());
+    m_nextFrame = 0;
+    m_inputLength = 0;
+}
+
+Scalar Spectrogram::sampleRate() const { return m_fs; }
+
+void Spectrogram::setSampleRate(const Scalar fs) {
+    if (!fuzzyEquals(m_fs, fs)) {
+        m_fs = fs;
+        setLayout(m_nfft, m_hop, m_frameCount);
+    }
+}
+
+void Spectrogram::write(const Scalar* samples, const int n) {
+    const int written = m_queue.push(samples, n);
+    if (written < n) {
+        m_droppedSamples.fetch_add(n - written, std::memory_order_relaxed);
+    }
+    if (!m_isSynchronous) {
+        m_wakeups.fetch_add(1);
+        m_wakeups.notify_one();
+    }
+}
+
+void Spectrogram::update() {
+    if (m_isSynchronous) {
+        analyzePending();
+    }
+}
+
+int Spectrogram::copyTo(std::vector<Scalar>& image, int binCount) {
+    std::lock_guard lock(m_mutex);
+
+    binCount = std::min(binCount, m_binCount);
+    image.resize(m_frameCount * binCount);
+
+    for (int row = 0; row < m_frameCount; ++row) {
+        const int  frame = (m_nextFrame - 1 - row + m_frameCount) % m_frameCount;
+        const auto first = std::next(m_frames.begin(), frame * m_binCount);
+        const auto last = std::next(first, binCount);
+        std::copy(first, last, std::next(image.begin(), row * binCount));
+    }
+    return m_frameCount;
+}
+
+uint64_t Spectrogram::droppedSamples() const { return m_droppedSamples.load(); }
+
+void Spectrogram::run() {
+    while (!m_stop) {
+        const uint32_t wakeups = m_wakeups.load();
+
+        if (m_queue.read_available() > 0) {
+            analyzePending();
+        } else {
+            m_wakeups.wait(wakeups);
+        }
+    }
+}
+
+void Spectrogram::analyzePending() {
+    const int count = m_queue.pop(m_chunk.data(), m_chunk.size());
+
+    std::lock_guard lock(m_mutex);
+
+    for (int i = 0; i < count;) {
+        const int length = std::min(count - i, m_nfft - m_inputLength);
+        std::copy_n(&m_chunk[i], length, &m_input[m_inputLength]);
+        m_inputLength += length;
+        i += length;
+
+        if (m_inputLength == m_nfft) {
+            analyzeFrame();
+            // Keep the overlap with the next frame.
+            std::copy(std::next(m_input.begin(), m_hop), m_input.end(), m_input.begin());
+            m_inputLength = m_nfft - m_hop;
+        }
+    }
+}
+
+void Spectrogram::analyzeFrame() {
+    // Windowed on a copy, the input still has to overlap the next frame.
+    for (int i = 0; i < m_nfft; ++i) {
+        m_windowed[i] = m_input[i] * m_window[i];
+    }
+    m_dtft.updateSamples(m_windowed.data(), m_nfft);
+
+    const int     binCount = m_binCount;
+    const Scalar* mags = m_dtft.magnitude();
+    Scalar*       levels = &m_frames[m_nextFrame * binCount];
+    for (int i = 0; i < binCount; ++i) {
+        levels[i] = 10 * vmath::log10(mags[i]);
+    }
+
+    m_nextFrame = (m_nextFrame + 1) % m_frameCount;
+}
@@ -0,0 +1,93 @@
+#ifndef SOURCEMODEL__SPECTROGRAM_H
+#define SOURCEMODEL__SPECTROGRAM_H
+
+#include <atomic>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "math/DTFT.h"
+#include "math/utils.h"
+
+/* Streaming short-time Fourier transform of a generator's output.
+ *
+ * The audio thread writes every block it produces into a bounded sample queue. A
+ * worker thread cuts the stream into windowed frames of transformSize() samples that
+ * start every hop() samples, and keeps the levels of the last frameCount() frames in
+ * a ring allocated when the layout is set. The UI copies the ring out as a waterfall.
+ */
+class Spectrogram {
+   public:
+    Spectrogram(int nfft = 1024, int hop = 256, int frameCount = 256);
+    ~Spectrogram();
+
+    Spectrogram(const Spectrogram&) = delete;
+    Spectrogram& operator=(const Spectrogram&) = delete;
+
+    int transformSize() const;
+    int hop() const;
+    int frameCount() const;
+    int binCount() const;
+
+    // Reallocates the frames and clears the history.
+    void setLayout(int nfft, int hop, int frameCount);
+
+    Scalar sampleRate() const;
+    void   setSampleRate(Scalar fs);
+
+    // Audio thread. Never blocks: samples that don't fit in the queue are dropped.
+    void write(const Scalar* samples, int n);
+
+    // UI thread. Analyzes the pending samples when there is no worker thread.
+    void update();
+
+    // UI thread. Levels in dB of the first binCount bins of every frame, one row per
+    // frame with the newest first, on the same scale as GeneratorSpectrum. Frames
+    // that haven't been analyzed yet are at -inf. Returns the number of rows.
+    int copyTo(std::vector<Scalar>& image, int binCount);
+
+    uint64_t droppedSamples() const;
+
+   private:
+    // About a second and a half at 44.1 kHz.
+    static constexpr int kQueueCapacity = 1 << 16;
+
+    void run();
+    void analyzePending();
+    void analyzeFrame();
+
+    // Layout, input and frames. Held by the worker while it analyzes.
+    std::mutex m_mutex;
+
+    int    m_nfft;
+    int    m_hop;
+    int    m_frameCount;
+    int    m_binCount;
+    Scalar m_fs;
+
+    std::vector<Scalar> m_window;
+    std::vector<Scalar> m_input;  // The next frame, oldest sample first.
+    int                 m_inputLength;
+    std::vector<Scalar> m_windowed;
+    DTFT<Scalar>        m_dtft;
+
+    std::vector<Scalar> m_frames;  // m_frameCount rows of m_binCount levels.
+    int                 m_nextFrame;
+
+    // Samples popped from the queue, only touched by the worker.
+    std::vector<Scalar> m_chunk;
+
+    boost::lockfree::spsc_queue<Scalar> m_queue;
+    std::atomic_uint64_t                m_droppedSamples;
+
+    std::atomic_uint32_t m_wakeups;
+    std::atomic_bool     m_stop;
+    std::thread          m_thread;
+
+    // No threads available (e.g. Emscripten without pthreads), analyze in update().
+    bool m_isSynchronous;
+};
+
+#endif  // SOURCEMODEL__SPECTROGRAM_H
@@ -0,0 +1,65 @@
+#include "SpectrumWorker.h"
+
+#include <algorithm>
+#include <system_error>
+
+SpectrumWorker::SpectrumWorker() : m_wakeups(0), m_stop(false), m_isSynchronous(false) {
+    try {
+        m_thread = std::thread(&SpectrumWorker::run, this);
+    } catch (const std::system_error&) {
+        m_isSynchronous = true;
+    }
+}
+
+SpectrumWorker::~SpectrumWorker() {
+    if (m_thread.joinable()) {
+        m_stop = true;
+        m_wakeups.fetch_add(1);
+        m_wakeups.notify_one();
+        m_thread.join();
+    }
+}
+
+void SpectrumWorker::add(Analysis* analysis) {
+    std::lock_guard lock(m_mutex);
+    m_analyses.push_back(analysis);
+}
+
+void SpectrumWorker::remove(Analysis* analysis) {
+    std::lock_guard lock(m_mutex);
+    m_analyses.erase(std::remove(m_analyses.begin(), m_analyses.end(), analysis),
+                     m_analyses.end());
+}
+
+void SpectrumWorker::requestUpdate() {
+    if (m_isSynchronous) {
+        analyzeAll();
+        return;
+    }
+
+    m_wakeups.fetch_add(1);
+    m_wakeups.notify_one();
+}
+
+void SpectrumWorker::run() {
+    uint32_t handled = 0;
+
+    while (!m_stop) {
+        // Requests made while analyzing are served by one more pass, not one per
+        // request.
+        const uint32_t wakeups = m_wakeups.load();
+        if (wakeups != handled) {
+            handled = wakeups;
+            analyzeAll();
+        } else {
+            m_wakeups.wait(wakeups);
+        }
+    }
+}
+
+void SpectrumWorker::analyzeAll() {
+    std::lock_guard lock(m_mutex);
+    for (Analysis* analysis : m_analyses) {
+        analysis->analyze();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SOURCEMODEL__SPECTRUM_WORKER_H
+#define SOURCEMODEL__SPECTRUM_WORKER_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Background thread that runs the spectrum analyses off the UI thread.
+ *
+ * Every requestUpdate() wakes the worker, which runs every registered analysis once.
+ * Analyses publish their results themselves (through a TripleBuffer) so the UI only
+ * ever picks up finished arrays and its frame rate doesn't depend on the transform
+ * size.
+ */
+class SpectrumWorker {
+   public:
+    class Analysis {
+       public:
+        virtual ~Analysis() = default;
+
+        // Worker thread, or the caller of requestUpdate() when synchronous.
+        virtual void analyze() = 0;
+    };
+
+    SpectrumWorker();
+    ~SpectrumWorker();
+
+    SpectrumWorker(const SpectrumWorker&) = delete;
+    SpectrumWorker& operator=(const SpectrumWorker&) = delete;
+
+    // Waits for the analysis in progress, if any.
+    void add(Analysis* analysis);
+    void remove(Analysis* analysis);
+
+    // UI thread. Runs every analysis again, inline if there is no worker thread.
+    void requestUpdate();
+
+   private:
+    void run();
+    void analyzeAll();
+
+    // Registered analyses. Held by the worker while it runs them.
+    std::mutex             m_mutex;
+    std::vector<Analysis*> m_analyses;
+
+    std::atomic_uint32_t m_wakeups;
+    std::atomic_bool     m_stop;
+    std::thread          m_thread;
+
+    // No threads available (e.g. Emscripten without pthreads), analyze inline.
+    bool m_isSynchronous;
+};
+
+#endif  // SOURCEMODEL__SPECTRUM_WORKER_H
@@ -0,0 +1,49 @@
+#ifndef SOURCEMODEL__TRIPLE_BUFFER_H
+#define SOURCEMODEL__TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+/* Hands the latest value from one writer thread to one reader thread without locks.
+ *
+ * The writer fills back() and publishes it, the reader takes the latest published
+ * value with fetch() and reads front() until the next fetch. Publishing swaps back()
+ * with a middle slot and fetching swaps front() with it, so neither side ever waits
+ * for the other or sees a value that is being written.
+ */
+template <typename T>
+class TripleBuffer {
+   public:
+    TripleBuffer() : m_front(0), m_middle(1), m_back(2) {}
+
+    // Writer.
+    T& back() { return m_slots[m_back]; }
+
+    // Writer. Makes back() the latest value, back() is then another slot.
+    void publish() {
+        m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    // Reader. Returns false if nothing was published since the last fetch.
+    bool fetch() {
+        if ((m_middle.load(std::memory_order_relaxed) & kFresh) == 0) {
+            return false;
+        }
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+
+    // Reader.
+    const T& front() const { return m_slots[m_front]; }
+
+   private:
+    static constexpr int kIndex = 3;
+    static constexpr int kFresh = 4;  // The middle slot hasn't been fetched yet.
+
+    std::array<T, 3> m_slots;
+    int              m_front;
+    std::atomic_int  m_middle;
+    int              m_back;
+};
+
+#endif  // SOURCEMODEL__TRIPLE_BUFFER_H
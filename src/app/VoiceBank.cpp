@@ -0,0 +1,262 @@
+#include "VoiceBank.h"
+
+#include <algorithm>
+#include <array>
+#include <boost/math/constants/constants.hpp>
+#include <boost/math/special_functions/cos_pi.hpp>
+#include <boost/math/special_functions/sin_pi.hpp>
+
+using namespace boost::math::constants;
+using boost::math::cos_pi;
+using boost::math::sin_pi;
+
+namespace {
+// Voices per chunk handed to the worker pool, large enough that neighbouring
+// chunks don't share cache lines of state.
+constexpr int kVoicesPerChunk = 8;
+
+constexpr std::array<Scalar, 13> jitterDistributionDeviations = {
+    -3, -1.9, -1.48, -1.12, -0.76, -0.38, 0, 0.38, 0.76, 1.12, 1.48, 1.9, 3};
+
+// Same weights as SourceGenerator (in 64ths), expanded so that a uniform 6-bit
+// random number indexes the deviation directly.
+constexpr std::array<Scalar, 64> jitterTable = [] {
+    constexpr std::array<int, 13> weights = {1, 2, 3, 5, 7, 9, 10, 9, 7, 5, 3, 2, 1};
+    std::array<Scalar, 64>        table{};
+    int                           i = 0;
+    for (int j = 0; j < 13; ++j) {
+        for (int w = 0; w < weights[j]; ++w) {
+            table[i++] = jitterDistributionDeviations[j];
+        }
+    }
+    return table;
+}();
+
+// xorshift64*: a few cycles per draw and 8 bytes of state per voice.
+inline uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+inline Scalar nextJitter(uint64_t& state) { return jitterTable[nextRandom(state) >> 58]; }
+
+inline Scalar nextUniform(uint64_t& state) {
+    return Scalar(nextRandom(state) >> 11) * 0x1.0p-53;
+}
+}  // namespace
+
+VoiceBank::VoiceBank(const int voiceCount, WorkerPool& pool, const Scalar fs,
+                     const int maxBlockSize)
+    : m_pool(pool),
+      m_voiceCount(voiceCount),
+      m_maxBlockSize(maxBlockSize),
+      m_fs(fs),
+      m_time(0),
+      m_f0(voiceCount, 120),
+      m_Fpmax(voiceCount, 0.02),
+      m_Jmax(voiceCount, 0.005),
+      m_Smax(voiceCount, 0.015),
+      m_gain(voiceCount, 1),
+      m_phase(voiceCount, 0),
+      m_phaseIncrement(voiceCount, 0),
+      m_currentShimmer(voiceCount, 1),
+      m_flutterOffset(voiceCount, 0),
+      m_rngState(voiceCount),
+      m_F(voiceCount * kNumFormants),
+      m_B(voiceCount * kNumFormants),
+      m_g(voiceCount * kNumFormants),
+      m_R2g(voiceCount * kNumFormants),
+      m_invDen(voiceCount * kNumFormants),
+      m_cHP(voiceCount * kNumFormants),
+      m_cBP(voiceCount * kNumFormants),
+      m_cLP(voiceCount * kNumFormants),
+      m_z1(voiceCount * kNumFormants, 0),
+      m_z2(voiceCount * kNumFormants, 0),
+      m_voiceOutput(voiceCount * maxBlockSize, 0) {
+    seed(0x9E3779B97F4A7C15ULL);
+
+    for (int v = 0; v < m_voiceCount; ++v) {
+        m_phaseIncrement[v] = m_f0[v] / m_fs;
+        for (int k = 0; k < kNumFormants; ++k) {
+            m_F[v * kNumFormants + k] = kDefaultF[k];
+            m_B[v * kNumFormants + k] = kDefaultB[k];
+            updateFormantCoefficients(v, k);
+        }
+    }
+}
+
+int VoiceBank::voiceCount() const { return m_voiceCount; }
+
+Scalar VoiceBank::sampleRate() const { return m_fs; }
+
+void VoiceBank::setSampleRate(const Scalar fs) {
+    m_fs = fs;
+    for (int v = 0; v < m_voiceCount; ++v) {
+        m_phaseIncrement[v] = m_f0[v] / m_fs;
+        for (int k = 0; k < kNumFormants; ++k) {
+            updateFormantCoefficients(v, k);
+        }
+    }
+}
+
+void VoiceBank::setGlottalFlowModel(const GlottalFlowModel& model) {
+    m_glottalTable.updateCache(&model);
+}
+
+void VoiceBank::setPitch(const int v, const Scalar f0) {
+    m_f0[v] = f0;
+    m_phaseIncrement[v] = f0 / m_fs;
+}
+
+void VoiceBank::setFlutter(const int v, const Scalar Fpmax) { m_Fpmax[v] = Fpmax; }
+
+void VoiceBank::setJitter(const int v, const Scalar Jmax) { m_Jmax[v] = Jmax; }
+
+void VoiceBank::setShimmer(const int v, const Scalar Smax) { m_Smax[v] = Smax; }
+
+void VoiceBank::setGain(const int v, const Scalar gain) { m_gain[v] = gain; }
+
+void VoiceBank::setFormant(const int v, const int k, const Scalar Fk, const Scalar Bk) {
+    m_F[v * kNumFormants + k] = Fk;
+    m_B[v * kNumFormants + k] = Bk;
+    updateFormantCoefficients(v, k);
+}
+
+void VoiceBank::seed(uint64_t seed) {
+    for (int v = 0; v < m_voiceCount; ++v) {
+        // splitmix64 to spread the seed, xorshift state must be non-zero.
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        m_rngState[v] = (z ^ (z >> 31)) | 1;
+
+        // Decorrelate the flutter of each voice.
+        m_flutterOffset[v] = 100 * nextUniform(m_rngState[v]);
+    }
+}
+
+void VoiceBank::process(Scalar* out, const int length) {
+    for (int offset = 0; offset < length; offset += m_maxBlockSize) {
+        const int blockLength = std::min(length - offset, m_maxBlockSize);
+
+        m_pool.parallelFor(m_voiceCount, kVoicesPerChunk, [&](int begin, int end) {
+            renderVoices(begin, end, blockLength);
+        });
+
+        if (out != nullptr) {
+            Scalar* mix = out + offset;
+            std::fill(mix, mix + blockLength, 0);
+            for (int v = 0; v < m_voiceCount; ++v) {
+                const Scalar* y = &m_voiceOutput[v * m_maxBlockSize];
+                for (int i = 0; i < blockLength; ++i) {
+                    mix[i] += y[i];
+                }
+            }
+        }
+
+        m_time += blockLength;
+    }
+}
+
+const Scalar* VoiceBank::voiceOutput(const int v) const {
+    return &m_voiceOutput[v * m_maxBlockSize];
+}
+
+void VoiceBank::renderVoices(const int begin, const int end, const int length) {
+    for (int v = begin; v < end; ++v) {
+        // Keep the voice state in locals for the duration of the block.
+        Scalar   phase = m_phase[v];
+        Scalar   phaseIncrement = m_phaseIncrement[v];
+        Scalar   shimmer = m_currentShimmer[v];
+        uint64_t rng = m_rngState[v];
+
+        const int fk = v * kNumFormants;
+
+        Scalar z1[kNumFormants], z2[kNumFormants];
+        for (int k = 0; k < kNumFormants; ++k) {
+            z1[k] = m_z1[fk + k];
+            z2[k] = m_z2[fk + k];
+        }
+
+        // Same level as FormantGenerator, whose lip filter is a flat -12 dB.
+        const Scalar gain = 0.25_f * m_gain[v];
+
+        Scalar* out = &m_voiceOutput[v * m_maxBlockSize];
+
+        for (int i = 0; i < length; ++i) {
+            Scalar y = m_glottalTable.get(phase) * shimmer;
+
+            phase += phaseIncrement;
+
+            if (phase >= 1) {
+                phase -= 1;
+
+                // Update f0 every period, same strategy as SourceGenerator.
+                const Scalar t = (m_time + i) / m_fs + m_flutterOffset[v];
+                const Scalar Fln = .1 * (sin_pi(2 * 12.7 * t) + sin_pi(2 * 7.1 * t) +
+                                         sin_pi(2 * 4.7 * t));
+                const Scalar Jn = nextJitter(rng);
+
+                const Scalar f0 = m_f0[v] * (1 + m_Fpmax[v] * Fln) * (1 + m_Jmax[v] * Jn);
+                phaseIncrement = f0 / m_fs;
+                shimmer = 1 + m_Smax[v] * nextJitter(rng);
+            }
+
+            for (int k = 0; k < kNumFormants; ++k) {
+                const Scalar g = m_g[fk + k];
+
+                const Scalar HP = (y - m_R2g[fk + k] * z1[k] - z2[k]) * m_invDen[fk + k];
+                const Scalar BP = HP * g + z1[k];
+                const Scalar LP = BP * g + z2[k];
+
+                z1[k] = g * HP + BP;
+                z2[k] = g * BP + LP;
+
+                y = m_cHP[fk + k] * HP + m_cBP[fk + k] * BP + m_cLP[fk + k] * LP;
+            }
+
+            out[i] = gain * y;
+        }
+
+        m_phase[v] = phase;
+        m_phaseIncrement[v] = phaseIncrement;
+        m_currentShimmer[v] = shimmer;
+        m_rngState[v] = rng;
+
+        for (int k = 0; k < kNumFormants; ++k) {
+            m_z1[fk + k] = z1[k];
+            m_z2[fk + k] = z2[k];
+        }
+    }
+}
+
+void VoiceBank::updateFormantCoefficients(const int v, const int k) {
+    const int i = v * kNumFormants + k;
+
+    const Scalar Fk = std::min(m_F[i], m_fs / 2);
+    const Scalar Bk = m_B[i];
+
+    // Same resonator as FormantFilterBank, normalized to unit gain at DC.
+    const Scalar r = std::exp(-pi<Scalar>() * Bk / m_fs);
+    const Scalar a1 = -2 * r * cos_pi(2 * Fk / m_fs);
+    const Scalar a2 = r * r;
+    const Scalar b0 = 1 + a1 + a2;
+
+    // SVFBiquad::update specialised to a stable resonator, where both
+    // m1 = -1 - a1 - a2 and m2 = -1 + a1 - a2 are negative.
+    const Scalar asm1 = std::sqrt(1 + a1 + a2);
+    const Scalar asm2 = std::sqrt(1 - a1 + a2);
+    const Scalar sm1mul2 = -asm1 * asm2;
+
+    const Scalar g = asm1 / asm2;
+    const Scalar R = (a2 - 1) / sm1mul2;
+
+    m_g[i] = g;
+    m_R2g[i] = 2 * R + g;
+    m_invDen[i] = 1 / (1 + 2 * R * g + g * g);
+    m_cHP[i] = b0 / (1 - a1 + a2);
+    m_cBP[i] = 2 * b0 / sm1mul2;
+    m_cLP[i] = b0 / (1 + a1 + a2);
+}
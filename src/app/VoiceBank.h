@@ -0,0 +1,102 @@
+#ifndef SOURCEMODEL__VOICE_BANK_H
+#define SOURCEMODEL__VOICE_BANK_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "CachedGlottalFlowModel.h"
+#include "GlottalFlowModel.h"
+#include "audio/WorkerPool.h"
+#include "math/utils.h"
+
+/* Many independent source-filter voices rendered together.
+ *
+ * Every piece of per-voice state lives in its own contiguous array (structure of
+ * arrays) instead of one SourceGenerator/FormantGenerator pair per voice, and each
+ * block is split across cores by a WorkerPool. All voices read one shared glottal
+ * flow table, so only the period phase, jitter/shimmer and filter memories are
+ * per-voice.
+ */
+class VoiceBank {
+   public:
+    static constexpr int kNumFormants = 5;
+
+    // Formants every voice starts with.
+    static constexpr std::array<Scalar, kNumFormants> kDefaultF = {800, 1150, 2900, 3900,
+                                                                   4650};
+    static constexpr std::array<Scalar, kNumFormants> kDefaultB = {80, 90, 120, 130, 140};
+
+    VoiceBank(int voiceCount, WorkerPool& pool, Scalar fs = 48000,
+              int maxBlockSize = 1024);
+
+    int voiceCount() const;
+
+    Scalar sampleRate() const;
+    void   setSampleRate(Scalar fs);
+
+    // Samples one period of a fitted model into the table shared by all voices.
+    void setGlottalFlowModel(const GlottalFlowModel& model);
+
+    void setPitch(int v, Scalar f0);
+    void setFlutter(int v, Scalar Fpmax);
+    void setJitter(int v, Scalar Jmax);
+    void setShimmer(int v, Scalar Smax);
+    void setGain(int v, Scalar gain);
+    void setFormant(int v, int k, Scalar Fk, Scalar Bk);
+
+    void seed(uint64_t seed);
+
+    // Renders every voice and writes their sum to out (if not null).
+    void process(Scalar* out, int length);
+
+    // Output of one voice for the last rendered block, up to maxBlockSize samples.
+    const Scalar* voiceOutput(int v) const;
+
+   private:
+    void renderVoices(int begin, int end, int length);
+    void updateFormantCoefficients(int v, int k);
+
+    WorkerPool& m_pool;
+
+    int      m_voiceCount;
+    int      m_maxBlockSize;
+    Scalar   m_fs;
+    uint64_t m_time;
+
+    CachedGlottalFlowModel m_glottalTable;
+
+    // Per-voice parameters.
+    std::vector<Scalar> m_f0;
+    std::vector<Scalar> m_Fpmax;
+    std::vector<Scalar> m_Jmax;
+    std::vector<Scalar> m_Smax;
+    std::vector<Scalar> m_gain;
+
+    // Per-voice source state.
+    std::vector<Scalar>   m_phase;
+    std::vector<Scalar>   m_phaseIncrement;
+    std::vector<Scalar>   m_currentShimmer;
+    std::vector<Scalar>   m_flutterOffset;
+    std::vector<uint64_t> m_rngState;
+
+    // Per-voice formant parameters, indexed [v * kNumFormants + k].
+    std::vector<Scalar> m_F;
+    std::vector<Scalar> m_B;
+
+    // SVF coefficients and memories, same indexing.
+    // Same single-state SVF as SVFBiquad, with 2R + g and the reciprocal precomputed.
+    std::vector<Scalar> m_g;
+    std::vector<Scalar> m_R2g;  // 2R + g
+    std::vector<Scalar> m_invDen;
+    std::vector<Scalar> m_cHP;
+    std::vector<Scalar> m_cBP;
+    std::vector<Scalar> m_cLP;
+    std::vector<Scalar> m_z1;
+    std::vector<Scalar> m_z2;
+
+    // Rendered blocks, indexed [v * maxBlockSize + i].
+    std::vector<Scalar> m_voiceOutput;
+};
+
+#endif  // SOURCEMODEL__VOICE_BANK_H
@@ -0,0 +1,56 @@
+#include "AudioBlock.h"
+
+#include <algorithm>
+
+void writeAudioBlock(const AudioBlock& block, const AudioRouting routing,
+                     const Scalar fade, const Scalar fadeStep, float* const output,
+                     const int channels, const int stride) {
+    // The last channel written, copied as is when the next one is the same.
+    const std::vector<Scalar>* lastSignal = nullptr;
+    Scalar                     lastGain = 0;
+
+    for (int c = 0; c < channels; ++c) {
+        float* const row = output + c * stride;
+
+        // Every channel plays at the same level whatever the routing, so switching it
+        // doesn't change the loudness of a signal.
+        const std::vector<Scalar>* signal = nullptr;
+        Scalar                     gain = 0;
+        if (routing == AudioRouting_Split && channels > 1) {
+            if (c == 0) {
+                signal = block.aux;
+                gain = block.auxGain / channels;
+            } else if (c == 1) {
+                signal = block.main;
+                gain = block.mainGain / channels;
+            }
+        } else {
+            signal = block.main;
+            gain = block.mainGain / channels;
+        }
+
+        const int length = block.length;
+        if (signal == nullptr) {
+            std::fill(row, row + length, 0.0f);
+            continue;
+        }
+        if (signal == lastSignal && gain == lastGain) {
+            std::copy(row - stride, row - stride + length, row);
+            continue;
+        }
+        lastSignal = signal;
+        lastGain = gain;
+
+        const Scalar* const x = signal->data();
+        if (fadeStep == 0) {
+            const Scalar totalGain = gain * fade;
+            for (int i = 0; i < length; ++i) {
+                row[i] = static_cast<float>(x[i] * totalGain);
+            }
+        } else {
+            for (int i = 0; i < length; ++i) {
+                row[i] = static_cast<float>(x[i] * gain * (fade + i * fadeStep));
+            }
+        }
+    }
+}
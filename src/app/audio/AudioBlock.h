@@ -0,0 +1,39 @@
+#ifndef SOURCEMODEL__AUDIO_AUDIO_BLOCK_H
+#define SOURCEMODEL__AUDIO_AUDIO_BLOCK_H
+
+#include <vector>
+
+#include "math/utils.h"
+
+// How the signals of a block are spread over the device channels.
+enum AudioRouting {
+    AudioRouting_Mono,   // The main signal on every channel, split evenly between them.
+    AudioRouting_Split,  // The aux signal on the first channel, main on the second,
+                         // each at the level of one channel in mono.
+};
+
+/* One block rendered by an output's buffer callback.
+ *
+ * The signals stay in whichever buffers the generators rendered them to, the output
+ * reads them once per channel while writing the device buffer. Gains are applied
+ * there too, so the callback doesn't need a pass of its own over the samples.
+ */
+struct AudioBlock {
+    int length;  // Samples to render, at most the output's kMaxBlockSize.
+
+    // Null for silence.
+    const std::vector<Scalar>* main;
+    Scalar                     mainGain;
+
+    // Only played with AudioRouting_Split, may stay null otherwise.
+    const std::vector<Scalar>* aux;
+    Scalar                     auxGain;
+};
+
+// Writes the block to a non-interleaved float buffer, channel c starting at
+// output[c * stride]. Every sample is also scaled by the fade, fade + i * fadeStep at
+// frame i. Channels without a signal are zeroed.
+void writeAudioBlock(const AudioBlock& block, AudioRouting routing, Scalar fade,
+                     Scalar fadeStep, float* output, int channels, int stride);
+
+#endif  // SOURCEMODEL__AUDIO_AUDIO_BLOCK_H
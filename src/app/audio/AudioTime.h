@@ -7,6 +7,9 @@ class AudioTime {
    public:
     virtual Scalar   time(int sampleOffset) const = 0;
     virtual uint64_t timeSamples(int sampleOffset) const = 0;
+
+    // Seconds between a sample being rendered and being heard.
+    virtual Scalar latency() const { return 0; }
 };
 
 #endif  // SOURCEMODEL__AUDIOTIME_H
\ No newline at end of file
@@ -1,19 +1,22 @@
 #include "BufferedGenerator.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 
+#include "Spectrogram.h"
 #include "audio/AudioTime.h"
 
 BufferedGenerator::BufferedGenerator(const AudioTime& time)
     : m_time(time),
       m_bufferLength(1024),
-      m_buffer(1024, 0),
+      m_buffer(kMaxBufferLength),
+      m_spectrogram(nullptr),
+      m_maxBlockSize(0),
+      m_delaySamples(0),
       m_fs(48000),
       m_fsChanged(false),
       m_isNormalized(true) {
-    m_buffer.set_capacity(1024);
-
     m_gainReductionComputer.setThreshold(10.0f);
     m_gainReductionComputer.setKnee(0.0f);
     m_gainReductionComputer.setAttackTime(10.0f / 1000);
@@ -24,48 +27,65 @@ BufferedGenerator::BufferedGenerator(const AudioTime& time)
     m_lookAheadGainReduction.setDelayTime(5.0f / 1000);
 }
 
-void BufferedGenerator::setBufferLength(const int bufferLength) {
-    if (m_bufferLength != bufferLength) {
-        std::unique_lock lock(m_mutex);
+void BufferedGenerator::prepare(const int maxBlockSize) {
+    m_maxBlockSize = maxBlockSize;
 
-        m_bufferLength = bufferLength;
-        m_buffer.rset_capacity(bufferLength);
-        m_buffer.rresize(bufferLength);
-    }
+    m_internalBuffer.reserve(maxBlockSize);
+    m_sidechainSignal.reserve(maxBlockSize);
+    m_gainReduction.reserve(maxBlockSize);
+
+    // Preparing for the highest rate sizes the look-ahead buffer for the longest delay,
+    // preparing for the actual rate in fillBuffer then only shrinks it.
+    m_lookAheadGainReduction.prepare(kMaxSampleRate, maxBlockSize);
+    m_delayBuffer.reserve(maxBlockSize + m_lookAheadGainReduction.getDelayInSamples());
+
+    prepareInternalBuffer(maxBlockSize);
+
+    // The next block re-prepares the gain reduction for the actual rate.
+    m_fsChanged = true;
 }
 
-uint64_t BufferedGenerator::copyBufferTo(std::vector<Scalar>& out) {
-    std::shared_lock lock(m_mutex);
+int BufferedGenerator::bufferLength() const { return m_bufferLength; }
 
-    if (out.size() < m_bufferLength) {
-        std::copy(std::prev(m_buffer.end(), out.size()), m_buffer.end(), out.begin());
-    } else {
-        std::copy(m_buffer.begin(), m_buffer.end(), out.begin());
-    }
-    return m_time.timeSamples(0);
+void BufferedGenerator::setBufferLength(const int bufferLength) {
+    m_bufferLength = std::min(bufferLength, kMaxBufferLength);
+}
+
+uint64_t BufferedGenerator::copyBufferTo(std::vector<Scalar>& out) {
+    const int count = std::min<int>(out.size(), m_bufferLength);
+    return m_buffer.read(out.data(), count);
 }
 
 bool BufferedGenerator::hasEnoughSamplesSince(uint64_t time, int count) {
-    return (m_time.timeSamples(0) - time) >= count;
+    return (m_buffer.end() - time) >= count;
+}
+
+void BufferedGenerator::setSpectrogram(Spectrogram* spectrogram) {
+    m_spectrogram = spectrogram;
 }
 
 void BufferedGenerator::fillBuffer(std::vector<Scalar>& out) {
+    using clock = std::chrono::steady_clock;
+    using nanoseconds = std::chrono::duration<double, std::nano>;
+
     // Backup if true it'll get set to false by fillInternalBuffer.
     const bool wasSampleRateChanged = m_fsChanged;
 
+    const auto startTime = clock::now();
+
     m_internalBuffer.resize(out.size());
     fillInternalBuffer(m_internalBuffer);
 
+    const auto generatedTime = clock::now();
+
     if (wasSampleRateChanged) {
         // Re-prepare the gain reduction stuff.
+        const int blockSize = std::max<int>(out.size(), m_maxBlockSize);
         m_gainReductionComputer.prepare(m_fs);
-        m_lookAheadGainReduction.prepare(m_fs, out.size());
-        // Resize the delay buffer.
+        m_lookAheadGainReduction.prepare(m_fs, blockSize);
+        // Restart the delay line with the new delay.
         m_delaySamples = m_lookAheadGainReduction.getDelayInSamples();
-        m_delayBuffer.rset_capacity(out.size() + m_delaySamples);
-        m_delayBuffer.rresize(out.size() + m_delaySamples);
-        std::fill(m_delayBuffer.begin(), std::next(m_delayBuffer.begin(), m_delaySamples),
-                  0.0_f);
+        m_delayBuffer.assign(m_delaySamples, 0.0_f);
     }
 
     m_delayBuffer.insert(m_delayBuffer.end(), m_internalBuffer.begin(),
@@ -75,13 +95,23 @@ void BufferedGenerator::fillBuffer(std::vector<Scalar>& out) {
         processGainReduction();
     }
 
-    // Copy into output and ring buffer.
+    const auto   endTime = clock::now();
+    const double blockDuration = 1e9 * out.size() / m_fs;
+    m_generatorLoad.record(nanoseconds(generatedTime - startTime).count(), blockDuration);
+    m_gainReductionLoad.record(nanoseconds(endTime - generatedTime).count(),
+                               blockDuration);
+
+    // Copy into output and keep the last m_delaySamples for the next block.
     std::copy(m_delayBuffer.begin(), std::next(m_delayBuffer.begin(), out.size()),
               out.begin());
+    m_delayBuffer.erase(m_delayBuffer.begin(),
+                        std::next(m_delayBuffer.begin(), out.size()));
+
+    m_buffer.write(out.data(), out.size(), m_time.timeSamples(0));
 
-    m_mutex.lock();
-    m_buffer.insert(m_buffer.end(), out.begin(), out.end());
-    m_mutex.unlock();
+    if (Spectrogram* spectrogram = m_spectrogram.load()) {
+        spectrogram->write(out.data(), out.size());
+    }
 }
 
 void BufferedGenerator::setSampleRate(const Scalar fs) {
@@ -95,6 +125,10 @@ void BufferedGenerator::setNormalized(const bool isNorm) { m_isNormalized = isNo
 
 bool BufferedGenerator::isNormalized() const { return m_isNormalized; }
 
+LoadMeter& BufferedGenerator::generatorLoad() { return m_generatorLoad; }
+
+LoadMeter& BufferedGenerator::gainReductionLoad() { return m_gainReductionLoad; }
+
 Scalar BufferedGenerator::fs() const { return m_fs; }
 
 bool BufferedGenerator::hasSampleRateChanged() const { return m_fsChanged; }
@@ -103,6 +137,12 @@ void BufferedGenerator::ackSampleRateChange() { m_fsChanged = false; }
 
 Scalar BufferedGenerator::time(const int off) const { return m_time.time(off); }
 
+uint64_t BufferedGenerator::timeSamples(const int off) const {
+    return m_time.timeSamples(off);
+}
+
+int BufferedGenerator::outputDelay() const { return m_delaySamples; }
+
 void BufferedGenerator::processGainReduction() {
     const int length = m_internalBuffer.size();
 
@@ -1,26 +1,47 @@
 #ifndef SOURCEMODEL__AUDIO_BUFFERED_GENERATOR_H
 #define SOURCEMODEL__AUDIO_BUFFERED_GENERATOR_H
 
-#include <boost/circular_buffer.hpp>
-#include <mutex>
-#include <shared_mutex>
+#include <atomic>
 #include <vector>
 
 #include "audio/GainReductionComputer.h"
+#include "audio/LoadMeter.h"
 #include "audio/LookAheadGainReduction.h"
+#include "audio/SampleRing.h"
 #include "math/utils.h"
 
 class AudioTime;
+class Spectrogram;
 
 class BufferedGenerator {
    public:
     BufferedGenerator(const AudioTime& time);
 
-    void     setBufferLength(int bufferLength);
+    // Longest buffer that can be copied, the largest transform size.
+    static constexpr int kMaxBufferLength = 32768;
+
+    // Highest sample rate prepare() allocates for.
+    static constexpr Scalar kMaxSampleRate = 192000;
+
+    // Allocates everything fillBuffer needs for blocks of up to maxBlockSize samples at
+    // up to kMaxSampleRate, so that the audio thread doesn't. Call before the stream
+    // starts. Larger blocks or rates still work, but allocate.
+    void prepare(int maxBlockSize);
+
+    // The ring always keeps kMaxBufferLength samples, this is only how many are copied.
+    int  bufferLength() const;
+    void setBufferLength(int bufferLength);
+
+    // Copies the last min(out.size(), bufferLength()) samples to the start of out.
+    // Returns the time right after the newest one, in samples. Never blocks the audio
+    // thread.
     uint64_t copyBufferTo(std::vector<Scalar>& out);
 
     bool hasEnoughSamplesSince(uint64_t time, int length);
 
+    // Every block produced from now on is also written to the spectrogram (or none).
+    void setSpectrogram(Spectrogram* spectrogram);
+
     void fillBuffer(std::vector<Scalar>& out);
 
     void   setSampleRate(Scalar fs);
@@ -29,10 +50,22 @@ class BufferedGenerator {
     void setNormalized(bool isNorm);
     bool isNormalized() const;
 
+    // Load of fillInternalBuffer, and of the compressor and its delay line.
+    LoadMeter& generatorLoad();
+    LoadMeter& gainReductionLoad();
+
    protected:
     virtual void fillInternalBuffer(std::vector<Scalar>& out) = 0;
 
-    Scalar time(int sampleOffset = 0) const;
+    // Reserves what fillInternalBuffer needs for blocks of up to maxBlockSize samples.
+    virtual void prepareInternalBuffer(int maxBlockSize) {}
+
+    Scalar   time(int sampleOffset = 0) const;
+    uint64_t timeSamples(int sampleOffset = 0) const;
+
+    // Samples between fillInternalBuffer's output and fillBuffer's, the compressor's
+    // look-ahead.
+    int outputDelay() const;
 
     bool   hasSampleRateChanged() const;
     void   ackSampleRateChange();
@@ -41,19 +74,20 @@ class BufferedGenerator {
    private:
     void processGainReduction();
 
-    template <typename T>
-    using cbso = boost::circular_buffer_space_optimized<T>;
-
     const AudioTime& m_time;
 
-    std::shared_mutex m_mutex;
-    int               m_bufferLength;
-    cbso<Scalar>      m_buffer;
+    std::atomic_int m_bufferLength;  // Read by whichever thread copies the buffer.
+    SampleRing      m_buffer;
+
+    std::atomic<Spectrogram*> m_spectrogram;
+
+    int m_maxBlockSize;  // Set by prepare(), 0 if it wasn't called.
 
     std::vector<Scalar> m_internalBuffer;  // Filled by fillInternalBuffer.
 
-    int          m_delaySamples;  // Compressor delay in samples.
-    cbso<Scalar> m_delayBuffer;
+    // Compressor delay line, the last m_delaySamples samples between blocks.
+    int                 m_delaySamples;
+    std::vector<Scalar> m_delayBuffer;
 
     Scalar m_fs;
     bool   m_fsChanged;
@@ -66,6 +100,9 @@ class BufferedGenerator {
     LookAheadGainReduction m_lookAheadGainReduction;
     std::vector<float>     m_sidechainSignal;
     std::vector<float>     m_gainReduction;
+
+    LoadMeter m_generatorLoad;
+    LoadMeter m_gainReductionLoad;
 };
 
 #endif  // SOURCEMODEL__AUDIO_BUFFERED_GENERATOR_H
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "LoadMeter.h"
+
+#include <algorithm>
+
+LoadMeter::LoadMeter()
+    : m_blocks(0), m_averageLoad(0), m_peakLoad(0), m_resetRequested(false) {
+    for (auto& count : m_histogram) {
+        count = 0;
+    }
+}
+
+void LoadMeter::record(const double elapsed, const double blockDuration) {
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    if (m_resetRequested.exchange(false, std::memory_order_acquire)) {
+        m_blocks.store(0, relaxed);
+        m_averageLoad.store(0, relaxed);
+        m_peakLoad.store(0, relaxed);
+        for (auto& count : m_histogram) {
+            count.store(0, relaxed);
+        }
+    }
+
+    const double load = (blockDuration > 0) ? elapsed / blockDuration : 0;
+    const int    bin = std::min<int>(load * (kHistogramBins - 1), kHistogramBins - 1);
+
+    // Only this thread writes, plain loads and stores are enough.
+    const uint64_t blocks = m_blocks.load(relaxed);
+    const double   average = m_averageLoad.load(relaxed);
+    // Exponential moving average over roughly the last 20 blocks.
+    m_averageLoad.store(blocks == 0 ? load : average + 0.05 * (load - average), relaxed);
+    m_peakLoad.store(std::max(m_peakLoad.load(relaxed), load), relaxed);
+    m_histogram[bin].store(m_histogram[bin].load(relaxed) + 1, relaxed);
+    m_blocks.store(blocks + 1, relaxed);
+}
+
+LoadMeter::Statistics LoadMeter::statistics() const {
+    Statistics statistics;
+    statistics.blocks = m_blocks.load(std::memory_order_relaxed);
+    statistics.averageLoad = m_averageLoad.load(std::memory_order_relaxed);
+    statistics.peakLoad = m_peakLoad.load(std::memory_order_relaxed);
+    for (int i = 0; i < kHistogramBins; ++i) {
+        statistics.histogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+void LoadMeter::reset() { m_resetRequested.store(true, std::memory_order_release); }
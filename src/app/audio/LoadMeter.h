@@ -0,0 +1,49 @@
+#ifndef SOURCEMODEL__AUDIO_LOAD_METER_H
+#define SOURCEMODEL__AUDIO_LOAD_METER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/* Load of a real-time stage: time spent computing a block over the block's duration.
+ *
+ * The audio thread records every block, any thread reads the statistics. A load of 1
+ * means the block took as long to compute as it takes to play, any more and the
+ * device underflows. Resets are carried out by the audio thread on its next block, so
+ * it stays the only writer.
+ */
+class LoadMeter {
+   public:
+    // Bins of 10% load, the last one collects every block at or above 100%.
+    static constexpr int kHistogramBins = 11;
+
+    struct Statistics {
+        uint64_t                             blocks;
+        double                               averageLoad;  // Over the last ~20 blocks.
+        double                               peakLoad;     // Since the last reset.
+        std::array<uint64_t, kHistogramBins> histogram;
+    };
+
+    LoadMeter();
+
+    LoadMeter(const LoadMeter&) = delete;
+    LoadMeter& operator=(const LoadMeter&) = delete;
+
+    // Audio thread. Both durations in nanoseconds.
+    void record(double elapsed, double blockDuration);
+
+    // Any thread.
+    Statistics statistics() const;
+    void       reset();
+
+   private:
+    std::atomic_uint64_t m_blocks;
+    std::atomic<double>  m_averageLoad;
+    std::atomic<double>  m_peakLoad;
+
+    std::array<std::atomic_uint64_t, kHistogramBins> m_histogram;
+
+    std::atomic_bool m_resetRequested;
+};
+
+#endif  // SOURCEMODEL__AUDIO_LOAD_METER_H
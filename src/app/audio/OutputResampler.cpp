@@ -0,0 +1,126 @@
+#include "OutputResampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+OutputResampler::OutputResampler()
+    : m_state(nullptr),
+      m_inRate(0),
+      m_outRate(0),
+      m_signals(0),
+      m_maxBlockSize(0),
+      m_ratio(1),
+      m_inputStart(0),
+      m_inputEnd(0) {}
+
+OutputResampler::~OutputResampler() { release(); }
+
+bool OutputResampler::prepare(const int inRate, const int outRate, const int signals,
+                              const int maxBlockSize) {
+    release();
+
+    // The output starts with latency() frames of silence, the filter's delay.
+    int err;
+    m_state = speex_resampler_init(signals, inRate, outRate,
+                                   SPEEX_RESAMPLER_QUALITY_DESKTOP, &err);
+    if (m_state == nullptr) {
+        return false;
+    }
+
+    m_inRate = inRate;
+    m_outRate = outRate;
+    m_signals = signals;
+    m_maxBlockSize = maxBlockSize;
+    m_ratio = double(inRate) / outRate;
+
+    for (int k = 0; k < signals; ++k) {
+        m_input[k].resize(maxBlockSize);
+        m_resampled[k].resize(maxBlockSize);
+        m_output[k].reserve(maxBlockSize);
+    }
+    m_inputStart = 0;
+    m_inputEnd = 0;
+
+    return true;
+}
+
+void OutputResampler::release() {
+    if (m_state != nullptr) {
+        speex_resampler_destroy(m_state);
+        m_state = nullptr;
+    }
+    m_inRate = 0;
+    m_outRate = 0;
+    m_signals = 0;
+}
+
+bool OutputResampler::isActive() const { return m_state != nullptr; }
+
+int OutputResampler::inRate() const { return m_inRate; }
+
+int OutputResampler::outRate() const { return m_outRate; }
+
+int OutputResampler::latency() const {
+    return (m_state != nullptr) ? speex_resampler_get_output_latency(m_state) : 0;
+}
+
+void OutputResampler::process(AudioBlock& out, const RenderCallback& render) {
+    const int length = out.length;
+
+    int produced = 0;
+    while (produced < length) {
+        if (m_inputStart == m_inputEnd) {
+            // About what the rest of the block takes, speex says if it was enough.
+            const int needed = std::ceil((length - produced) * m_ratio);
+
+            AudioBlock block{};
+            block.length = std::clamp(needed, kMinRenderLength, m_maxBlockSize);
+            block.mainGain = 1;
+            block.auxGain = 1;
+            const bool hasSignal = render(block);
+
+            const std::vector<Scalar>* signals[kMaxSignals] = {block.main, block.aux};
+            const Scalar gains[kMaxSignals] = {block.mainGain, block.auxGain};
+            for (int k = 0; k < m_signals; ++k) {
+                float* const input = m_input[k].data();
+                if (!hasSignal || signals[k] == nullptr) {
+                    std::fill(input, input + block.length, 0.0f);
+                    continue;
+                }
+                // Flush what would become float denormals, they slow speex down.
+                const Scalar* const x = signals[k]->data();
+                for (int i = 0; i < block.length; ++i) {
+                    const Scalar y = x[i] * gains[k];
+                    input[i] = std::abs(y) < 1e-30_f ? 0.0f : float(y);
+                }
+            }
+            m_inputStart = 0;
+            m_inputEnd = block.length;
+        }
+
+        // Same rates and lengths, so every signal consumes and produces alike.
+        spx_uint32_t inLength = 0;
+        spx_uint32_t outLength = 0;
+        for (int k = 0; k < m_signals; ++k) {
+            inLength = m_inputEnd - m_inputStart;
+            outLength = length - produced;
+            speex_resampler_process_float(m_state, k, &m_input[k][m_inputStart],
+                                          &inLength, &m_resampled[k][produced],
+                                          &outLength);
+        }
+        m_inputStart += inLength;
+        produced += outLength;
+    }
+
+    for (int k = 0; k < m_signals; ++k) {
+        // Within the capacity reserved by prepare().
+        m_output[k].resize(length);
+        std::copy(m_resampled[k].begin(), std::next(m_resampled[k].begin(), length),
+                  m_output[k].begin());
+    }
+
+    out.main = &m_output[0];
+    out.mainGain = 1;
+    out.aux = (m_signals > 1) ? &m_output[1] : nullptr;
+    out.auxGain = 1;
+}
@@ -0,0 +1,70 @@
+#ifndef SOURCEMODEL__AUDIO_OUTPUT_RESAMPLER_H
+#define SOURCEMODEL__AUDIO_OUTPUT_RESAMPLER_H
+
+#include <speex_resampler.h>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "AudioBlock.h"
+
+/* Converts the blocks of an engine running at a fixed rate to the device rate.
+ *
+ * The output asks for as many frames as its device wants. The resampler renders as
+ * many engine blocks as that takes, and keeps the input it couldn't use yet for the
+ * next call. The signals of the blocks are resampled with their gains applied, so
+ * what comes out is a block at the device rate with unit gains.
+ */
+class OutputResampler {
+   public:
+    // Renders one engine block, see AudioOutput::BufferCallback.
+    using RenderCallback = std::function<bool(AudioBlock&)>;
+
+    OutputResampler();
+    ~OutputResampler();
+
+    OutputResampler(const OutputResampler&) = delete;
+    OutputResampler& operator=(const OutputResampler&) = delete;
+
+    // Allocates everything for output blocks of up to maxBlockSize frames, never call
+    // it while process() runs. With one signal only main is resampled, with two aux
+    // too. Returns false (and stays inactive) if speex can't convert between the rates.
+    bool prepare(int inRate, int outRate, int signals, int maxBlockSize);
+    void release();
+
+    bool isActive() const;
+    int  inRate() const;
+    int  outRate() const;
+
+    // Delay of the filter, in output frames.
+    int latency() const;
+
+    // Fills out.length frames at the output rate, out.length at most maxBlockSize.
+    // Engine blocks are at most maxBlockSize frames too.
+    void process(AudioBlock& out, const RenderCallback& render);
+
+   private:
+    static constexpr int kMaxSignals = 2;  // AudioBlock's main and aux.
+
+    // Shortest engine block rendered, so that rounding doesn't make single frames.
+    static constexpr int kMinRenderLength = 64;
+
+    SpeexResamplerState* m_state;
+
+    int    m_inRate;
+    int    m_outRate;
+    int    m_signals;
+    int    m_maxBlockSize;
+    double m_ratio;  // Input frames per output frame.
+
+    // Engine frames not consumed yet, [m_inputStart, m_inputEnd).
+    std::array<std::vector<float>, kMaxSignals> m_input;
+    int                                      m_inputStart;
+    int                                      m_inputEnd;
+
+    std::array<std::vector<float>, kMaxSignals>  m_resampled;
+    std::array<std::vector<Scalar>, kMaxSignals> m_output;  // Where out points at.
+};
+
+#endif  // SOURCEMODEL__AUDIO_OUTPUT_RESAMPLER_H
@@ -0,0 +1,197 @@
+#include "RealtimeAudit.h"
+
+#ifdef SOURCEMODEL_RT_AUDIT
+
+    #include <atomic>
+    #include <cstdio>
+    #include <cstdlib>
+    #include <new>
+
+    #ifdef __GLIBC__
+        #include <dlfcn.h>
+        #include <pthread.h>
+
+        #include <cerrno>
+    #endif
+
+namespace {
+
+enum Violation {
+    Violation_Allocation,
+    Violation_Deallocation,
+    Violation_Lock,
+};
+
+// Static TLS in the executable, reading these never allocates.
+thread_local int  t_realtimeDepth = 0;
+thread_local int  t_allowDepth = 0;
+thread_local bool t_isReporting = false;
+
+std::atomic_uint64_t g_allocations(0);
+std::atomic_uint64_t g_deallocations(0);
+std::atomic_uint64_t g_locks(0);
+std::atomic_bool     g_abortOnViolation(false);
+
+inline bool isChecked() {
+    return t_realtimeDepth > 0 && t_allowDepth == 0 && !t_isReporting;
+}
+
+void report(const Violation violation) {
+    static constexpr const char* kNames[] = {"allocation", "deallocation", "lock"};
+
+    // Whatever the reporting itself does isn't counted.
+    t_isReporting = true;
+
+    switch (violation) {
+        case Violation_Allocation:
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case Violation_Deallocation:
+            g_deallocations.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case Violation_Lock:
+            g_locks.fetch_add(1, std::memory_order_relaxed);
+            break;
+    }
+
+    if (g_abortOnViolation.load(std::memory_order_relaxed)) {
+        std::fprintf(stderr, "RealtimeAudit: %s on the audio thread\n",
+                     kNames[violation]);
+        std::abort();
+    }
+
+    t_isReporting = false;
+}
+
+inline void check(const Violation violation) {
+    if (isChecked()) {
+        report(violation);
+    }
+}
+
+}  // namespace
+
+RealtimeAudit::Scope::Scope() { ++t_realtimeDepth; }
+
+RealtimeAudit::Scope::~Scope() { --t_realtimeDepth; }
+
+RealtimeAudit::AllowScope::AllowScope() { ++t_allowDepth; }
+
+RealtimeAudit::AllowScope::~AllowScope() { --t_allowDepth; }
+
+RealtimeAudit::Counts RealtimeAudit::counts() {
+    return {g_allocations.load(), g_deallocations.load(), g_locks.load()};
+}
+
+void RealtimeAudit::resetCounts() {
+    g_allocations = 0;
+    g_deallocations = 0;
+    g_locks = 0;
+}
+
+void RealtimeAudit::setAbortOnViolation(const bool abort) { g_abortOnViolation = abort; }
+
+    #ifdef __GLIBC__
+
+// glibc lets the program replace malloc and friends, which also catches allocations
+// made by C libraries (speex, FFTW) and not only operator new. The originals stay
+// reachable as __libc_*.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void  __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    check(Violation_Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    check(Violation_Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    check(Violation_Allocation);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    check(Violation_Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    check(Violation_Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    check(Violation_Allocation);
+    void* p = __libc_memalign(alignment, size);
+    if (p == nullptr) {
+        return ENOMEM;
+    }
+    *ptr = p;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (ptr != nullptr) {
+        check(Violation_Deallocation);
+    }
+    __libc_free(ptr);
+}
+
+// std::mutex and std::shared_mutex end up here. The next definitions are looked up
+// lazily, dlsym itself doesn't go through them.
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    using Lock = int (*)(pthread_mutex_t*);
+    static const auto next = reinterpret_cast<Lock>(dlsym(RTLD_NEXT, __func__));
+    check(Violation_Lock);
+    return next(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock) {
+    using Lock = int (*)(pthread_rwlock_t*);
+    static const auto next = reinterpret_cast<Lock>(dlsym(RTLD_NEXT, __func__));
+    check(Violation_Lock);
+    return next(rwlock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock) {
+    using Lock = int (*)(pthread_rwlock_t*);
+    static const auto next = reinterpret_cast<Lock>(dlsym(RTLD_NEXT, __func__));
+    check(Violation_Lock);
+    return next(rwlock);
+}
+}
+
+    #else
+
+// Elsewhere only C++ allocations are seen, and locks aren't.
+void* operator new(const std::size_t size) {
+    check(Violation_Allocation);
+    if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        check(Violation_Deallocation);
+    }
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept { operator delete(ptr); }
+
+    #endif  // __GLIBC__
+
+#endif  // SOURCEMODEL_RT_AUDIT
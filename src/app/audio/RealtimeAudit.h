@@ -0,0 +1,66 @@
+#ifndef SOURCEMODEL__AUDIO_REALTIME_AUDIT_H
+#define SOURCEMODEL__AUDIO_REALTIME_AUDIT_H
+
+#include <cstdint>
+
+/* Checks that the audio thread neither allocates nor takes locks.
+ *
+ * Built with SOURCEMODEL_RT_AUDIT, every heap allocation, deallocation and mutex
+ * acquisition made by a thread inside a Scope is counted as a violation, and aborts
+ * the program if abortOnViolation is set. Allocations are caught by replacing malloc
+ * (glibc) or operator new/delete (elsewhere), mutexes by interposing the pthread lock
+ * functions (glibc only). Without the flag, everything here compiles to nothing.
+ */
+class RealtimeAudit {
+   public:
+    struct Counts {
+        uint64_t allocations;
+        uint64_t deallocations;
+        uint64_t locks;
+    };
+
+    // Marks the calling thread as real-time while it exists. Scopes nest.
+    class Scope {
+       public:
+#ifdef SOURCEMODEL_RT_AUDIT
+        Scope();
+        ~Scope();
+#else
+        Scope() {}
+#endif
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Suspends the checks of the calling thread while it exists, around work that
+    // is known to allocate but only happens when the stream is reconfigured.
+    class AllowScope {
+       public:
+#ifdef SOURCEMODEL_RT_AUDIT
+        AllowScope();
+        ~AllowScope();
+#else
+        AllowScope() {}
+#endif
+        AllowScope(const AllowScope&) = delete;
+        AllowScope& operator=(const AllowScope&) = delete;
+    };
+
+#ifdef SOURCEMODEL_RT_AUDIT
+    static constexpr bool kEnabled = true;
+
+    static Counts counts();
+    static void   resetCounts();
+
+    static void setAbortOnViolation(bool abort);
+#else
+    static constexpr bool kEnabled = false;
+
+    static Counts counts() { return {}; }
+    static void   resetCounts() {}
+
+    static void setAbortOnViolation(bool) {}
+#endif
+};
+
+#endif  // SOURCEMODEL__AUDIO_REALTIME_AUDIT_H
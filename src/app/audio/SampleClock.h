@@ -0,0 +1,34 @@
+#ifndef SOURCEMODEL__AUDIO_SAMPLE_CLOCK_H
+#define SOURCEMODEL__AUDIO_SAMPLE_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "AudioTime.h"
+
+// Synthetic clock for driving generators without an audio device.
+// Whoever renders the blocks is responsible for advancing it afterwards.
+class SampleClock : public AudioTime {
+   public:
+    SampleClock(Scalar fs = 48000) : m_fs(fs), m_time(0) {}
+
+    Scalar sampleRate() const { return m_fs; }
+    void   setSampleRate(Scalar fs) { m_fs = fs; }
+
+    void advance(const int sampleCount) { m_time += sampleCount; }
+    void reset() { m_time = 0; }
+
+    Scalar time(const int sampleOffset) const override {
+        return (sampleOffset + m_time) / m_fs;
+    }
+
+    uint64_t timeSamples(const int sampleOffset) const override {
+        return sampleOffset + m_time;
+    }
+
+   private:
+    Scalar               m_fs;
+    std::atomic_uint64_t m_time;
+};
+
+#endif  // SOURCEMODEL__AUDIO_SAMPLE_CLOCK_H
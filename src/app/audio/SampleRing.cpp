@@ -0,0 +1,66 @@
+#include "SampleRing.h"
+
+#include <algorithm>
+#include <bit>
+
+SampleRing::SampleRing(const int capacity)
+    : m_mask(std::bit_ceil(unsigned(std::max(capacity, 1))) - 1),
+      m_samples(new std::atomic<Scalar>[m_mask + 1]),
+      m_claimed(0),
+      m_written(0),
+      m_timeOffset(0) {
+    for (int i = 0; i <= m_mask; ++i) {
+        m_samples[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int SampleRing::capacity() const { return m_mask + 1; }
+
+void SampleRing::write(const Scalar* samples, const int count, const uint64_t time) {
+    const uint64_t start = m_written.load(std::memory_order_relaxed);
+
+    // Readers that see any of the new samples also see the claim.
+    m_claimed.store(start + count, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_timeOffset.store(int64_t(time - start), std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        m_samples[(start + i) & m_mask].store(samples[i], std::memory_order_relaxed);
+    }
+
+    m_written.store(start + count, std::memory_order_release);
+}
+
+uint64_t SampleRing::read(Scalar* out, int count) const {
+    count = std::min(count, capacity());
+
+    while (true) {
+        const uint64_t written = m_written.load(std::memory_order_acquire);
+        const int64_t  timeOffset = m_timeOffset.load(std::memory_order_relaxed);
+
+        // Before the first write the ring is all zeros, read those.
+        const uint64_t first = written - count;
+        for (int i = 0; i < count; ++i) {
+            out[i] = m_samples[(first + i) & m_mask].load(std::memory_order_relaxed);
+        }
+
+        // A write that started since may have reclaimed some of the slots or moved the
+        // stream, copy again. Writes are short and far apart, this is rare.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_claimed.load(std::memory_order_relaxed) == written) {
+            return written + timeOffset;
+        }
+    }
+}
+
+uint64_t SampleRing::end() const {
+    while (true) {
+        const uint64_t written = m_written.load(std::memory_order_acquire);
+        const int64_t  timeOffset = m_timeOffset.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_claimed.load(std::memory_order_relaxed) == written) {
+            return written + timeOffset;
+        }
+    }
+}
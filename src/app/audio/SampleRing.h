@@ -0,0 +1,52 @@
+#ifndef SOURCEMODEL__AUDIO_SAMPLE_RING_H
+#define SOURCEMODEL__AUDIO_SAMPLE_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "math/utils.h"
+
+/* Ring of the most recent samples of a stream, one writer and any number of readers.
+ *
+ * The writer never waits: it claims the slots it is about to overwrite by publishing
+ * a sequence number, writes them, then publishes a second sequence number. A reader
+ * copies a snapshot up to the second one and checks afterwards that no write has
+ * claimed anything since, copying again if one has. The capacity is a power of two
+ * fixed at construction, nothing is allocated afterwards.
+ */
+class SampleRing {
+   public:
+    // capacity is rounded up to a power of two.
+    explicit SampleRing(int capacity);
+
+    SampleRing(const SampleRing&) = delete;
+    SampleRing& operator=(const SampleRing&) = delete;
+
+    int capacity() const;
+
+    // Writer only. time is the stream position of the first sample, in samples.
+    void write(const Scalar* samples, int count, uint64_t time);
+
+    // Any thread. Copies the last count samples (at most capacity()) to out, oldest
+    // first, with zeros before the first write. Returns the stream position right
+    // after the newest sample.
+    uint64_t read(Scalar* out, int count) const;
+
+    // Any thread. Stream position right after the newest sample.
+    uint64_t end() const;
+
+   private:
+    int                                    m_mask;
+    std::unique_ptr<std::atomic<Scalar>[]> m_samples;
+
+    // Sample counts since construction. m_claimed moves before a write, m_written
+    // after it.
+    std::atomic_uint64_t m_claimed;
+    std::atomic_uint64_t m_written;
+
+    // Stream position minus sample count, changes when the stream jumps.
+    std::atomic_int64_t m_timeOffset;
+};
+
+#endif  // SOURCEMODEL__AUDIO_SAMPLE_RING_H
@@ -0,0 +1,166 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+namespace {
+constexpr uint64_t packRange(const uint32_t first, const uint32_t last) {
+    return (uint64_t(first) << 32) | last;
+}
+
+constexpr uint32_t rangeFirst(const uint64_t range) { return range >> 32; }
+
+constexpr uint32_t rangeLast(const uint64_t range) { return range & 0xFFFFFFFF; }
+}  // namespace
+
+WorkerPool::WorkerPool(int threadCount)
+    : m_fn(nullptr),
+      m_ctx(nullptr),
+      m_count(0),
+      m_grainSize(1),
+      m_generation(0),
+      m_busyWorkers(0),
+      m_remainingChunks(0),
+      m_stop(false) {
+    if (threadCount <= 0) {
+        threadCount = std::max<int>(std::thread::hardware_concurrency(), 1) - 1;
+    }
+
+    m_participantCount = threadCount + 1;
+    m_participants = std::make_unique<Participant[]>(m_participantCount);
+
+    m_threads.reserve(threadCount);
+    for (int i = 1; i <= threadCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    m_stop = true;
+    m_generation.fetch_add(1);
+    m_generation.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+int WorkerPool::threadCount() const { return m_threads.size(); }
+
+void WorkerPool::run(const int count, const int grainSize, const ChunkFn fn,
+                     void* const ctx) {
+    if (count <= 0) {
+        return;
+    }
+
+    const int chunkCount = (count + grainSize - 1) / grainSize;
+
+    if (m_threads.empty() || chunkCount == 1) {
+        fn(ctx, 0, count);
+        return;
+    }
+
+    lockJob();
+
+    // Workers still scanning the previous job's ranges must leave before they get reset.
+    while (m_busyWorkers.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    m_fn = fn;
+    m_ctx = ctx;
+    m_count = count;
+    m_grainSize = grainSize;
+    m_remainingChunks = chunkCount;
+
+    // Split the chunks evenly, each participant starts with a contiguous range.
+    for (int i = 0; i < m_participantCount; ++i) {
+        const uint32_t first = (uint64_t(chunkCount) * i) / m_participantCount;
+        const uint32_t last = (uint64_t(chunkCount) * (i + 1)) / m_participantCount;
+        m_participants[i].range.store(packRange(first, last));
+    }
+
+    m_generation.fetch_add(1);
+    unlockJob();
+    m_generation.notify_all();
+
+    participate(0);
+
+    while (m_remainingChunks.load() > 0 || m_busyWorkers.load() > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void WorkerPool::workerLoop(const int index) {
+    uint32_t seenGeneration = m_generation.load();
+
+    while (true) {
+        m_generation.wait(seenGeneration);
+
+        if (m_stop) {
+            return;
+        }
+
+        // Register under the job lock so the caller can't start resetting the ranges
+        // for the next job while this worker is still looking at them.
+        lockJob();
+        seenGeneration = m_generation.load();
+        m_busyWorkers.fetch_add(1);
+        unlockJob();
+
+        participate(index);
+
+        m_busyWorkers.fetch_sub(1);
+    }
+}
+
+void WorkerPool::participate(const int index) {
+    int chunk;
+    while (popChunk(index, chunk) || stealChunk(index, chunk)) {
+        runChunk(chunk);
+    }
+}
+
+bool WorkerPool::popChunk(const int index, int& chunk) {
+    auto&    range = m_participants[index].range;
+    uint64_t current = range.load();
+
+    while (rangeFirst(current) < rangeLast(current)) {
+        const uint64_t next = packRange(rangeFirst(current) + 1, rangeLast(current));
+        if (range.compare_exchange_weak(current, next)) {
+            chunk = rangeFirst(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::stealChunk(const int thief, int& chunk) {
+    for (int offset = 1; offset < m_participantCount; ++offset) {
+        auto&    range = m_participants[(thief + offset) % m_participantCount].range;
+        uint64_t current = range.load();
+
+        while (rangeFirst(current) < rangeLast(current)) {
+            const uint64_t next = packRange(rangeFirst(current), rangeLast(current) - 1);
+            if (range.compare_exchange_weak(current, next)) {
+                chunk = rangeLast(current) - 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WorkerPool::runChunk(const int chunk) {
+    const int begin = chunk * m_grainSize;
+    const int end = std::min(begin + m_grainSize, m_count);
+    m_fn(m_ctx, begin, end);
+    m_remainingChunks.fetch_sub(1);
+}
+
+void WorkerPool::lockJob() {
+    while (m_jobLock.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void WorkerPool::unlockJob() { m_jobLock.clear(std::memory_order_release); }
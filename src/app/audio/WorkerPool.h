@@ -0,0 +1,74 @@
+#ifndef SOURCEMODEL__AUDIO_WORKER_POOL_H
+#define SOURCEMODEL__AUDIO_WORKER_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/* Fixed set of worker threads for splitting audio blocks across cores.
+ *
+ * parallelFor() cuts [0, count) into chunks of grainSize items and hands each
+ * participant (the calling thread plus every worker) a contiguous range of chunks.
+ * A participant pops chunks from the front of its own range and, once it runs dry,
+ * steals chunks from the back of the others'. Each range is a single atomic word so
+ * popping and stealing are lock-free, and nothing is allocated after construction.
+ */
+class WorkerPool {
+   public:
+    // threadCount = 0 picks one worker per hardware thread, minus the caller.
+    explicit WorkerPool(int threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int threadCount() const;
+
+    // Calls fn(begin, end) for every chunk and returns when all of them are done.
+    template <typename Fn>
+    void parallelFor(int count, int grainSize, Fn&& fn) {
+        using F = std::remove_reference_t<Fn>;
+        run(count, grainSize,
+            [](void* ctx, int begin, int end) { (*static_cast<F*>(ctx))(begin, end); },
+            const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+   private:
+    using ChunkFn = void (*)(void* ctx, int begin, int end);
+
+    struct alignas(64) Participant {
+        // Remaining chunk indices, packed as (first << 32) | last.
+        std::atomic_uint64_t range{0};
+    };
+
+    void run(int count, int grainSize, ChunkFn fn, void* ctx);
+    void workerLoop(int index);
+    void participate(int index);
+    bool popChunk(int index, int& chunk);
+    bool stealChunk(int thief, int& chunk);
+    void runChunk(int chunk);
+
+    void lockJob();
+    void unlockJob();
+
+    std::vector<std::thread>       m_threads;
+    std::unique_ptr<Participant[]> m_participants;
+    int                            m_participantCount;
+
+    // Current job, written by the caller while holding the job lock.
+    ChunkFn m_fn;
+    void*   m_ctx;
+    int     m_count;
+    int     m_grainSize;
+
+    std::atomic_flag     m_jobLock;
+    std::atomic_uint32_t m_generation;
+    std::atomic_int      m_busyWorkers;
+    std::atomic_int      m_remainingChunks;
+    std::atomic_bool     m_stop;
+};
+
+#endif  // SOURCEMODEL__AUDIO_WORKER_POOL_H
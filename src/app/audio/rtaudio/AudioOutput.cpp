@@ -1,6 +1,11 @@
 #include "AudioOutput.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <thread>
+
+#include "../RealtimeAudit.h"
 
 inline void atomic_add(std::atomic<Scalar> &ad, const Scalar plus) {
     Scalar desired, expected = ad.load(std::memory_order_relaxed);
@@ -9,8 +14,31 @@ inline void atomic_add(std::atomic<Scalar> &ad, const Scalar plus) {
     } while (!ad.compare_exchange_weak(expected, desired));  // seq_cst
 }
 
-AudioOutput::AudioOutput(RtAudio &audio) : m_audio(audio), m_timeOffset(0), m_time(0) {
+AudioOutput::AudioOutput(RtAudio &audio)
+    : m_audio(audio),
+      m_bufferSize(1024),
+      m_numberOfBuffers(0),
+      m_minimizeLatency(false),
+      m_pendingRenderSampleRate(0),
+      m_renderSampleRate(0),
+      m_streamBufferSize(0),
+      m_latencyFrames(0),
+      m_isLatencyReported(false),
+      m_fade(Fade_None),
+      m_routing(AudioRouting_Mono),
+      m_pendingRouting(AudioRouting_Mono),
+      m_isRenderRateSupported(true),
+      m_timeOffset(0),
+      m_time(0),
+      m_underflows(0),
+      m_overflows(0) {
     m_device = audio.getDeviceInfo(audio.getDefaultOutputDevice());
+
+    m_renderBlock = [this](AudioBlock &block) {
+        const bool hasSignal = m_bufferCallback(block);
+        m_time += block.length;
+        return hasSignal;
+    };
 }
 
 AudioOutput::~AudioOutput() {
@@ -23,18 +51,10 @@ AudioOutput::~AudioOutput() {
 }
 
 void AudioOutput::setDevice(const RtAudio::DeviceInfo &device) {
-    bool restart = m_audio.isStreamRunning();
-    if (restart) {
-        stopPlaying();
-    }
-    if (m_audio.isStreamOpen()) {
-        closeStream();
-    }
-
     m_device = device;
     std::cout << "AudioOutput: device set: " << device.name << std::endl;
 
-    if (restart) startPlaying();
+    reopenStream();
 }
 
 void AudioOutput::setBufferCallback(BufferCallback callback) {
@@ -46,17 +66,20 @@ void AudioOutput::startPlaying() {
         openStream();
     }
 
+    m_fade = Fade_In;
     m_audio.startStream();
 
     std::cout << "AudioOutput: playback started" << std::endl;
 }
 
 void AudioOutput::stopPlaying() {
+    fadeOut();
+    // Plays what is already queued, the end of the fade.
     m_audio.stopStream();
 
     // Set the stop time as the new offset.
-    atomic_add(m_timeOffset, m_time / (Scalar)m_audio.getStreamSampleRate());
-    // m_timeOffset += m_time / (Scalar)m_audio.getStreamSampleRate();
+    atomic_add(m_timeOffset, m_time / sampleRate());
+    // m_timeOffset += m_time / sampleRate();
     m_time = 0;
 
     std::cout << "AudioOutput: playback stopped" << std::endl;
@@ -65,6 +88,11 @@ void AudioOutput::stopPlaying() {
 bool AudioOutput::isPlaying() const { return m_audio.isStreamRunning(); }
 
 Scalar AudioOutput::sampleRate() const {
+    const int renderRate = m_renderSampleRate;
+    return (renderRate > 0) ? renderRate : deviceSampleRate();
+}
+
+Scalar AudioOutput::deviceSampleRate() const {
     if (m_audio.isStreamOpen()) {
         return m_audio.getStreamSampleRate();
     } else {
@@ -72,6 +100,15 @@ Scalar AudioOutput::sampleRate() const {
     }
 }
 
+int AudioOutput::renderSampleRate() const { return m_pendingRenderSampleRate; }
+
+void AudioOutput::setRenderSampleRate(const int rate) {
+    m_pendingRenderSampleRate = rate;
+    reopenStream();
+}
+
+bool AudioOutput::isResampling() const { return m_resampler.isActive(); }
+
 Scalar AudioOutput::time(const int sampleOffset) const {
     return m_timeOffset + (sampleOffset + m_time) / sampleRate();
 }
@@ -80,6 +117,64 @@ uint64_t AudioOutput::timeSamples(const int sampleOffset) const {
     return m_timeOffset * sampleRate() + sampleOffset + m_time;
 }
 
+int AudioOutput::bufferSize() const { return m_bufferSize; }
+
+void AudioOutput::setBufferSize(const int frames) {
+    m_bufferSize = frames;
+    reopenStream();
+}
+
+int AudioOutput::numberOfBuffers() const { return m_numberOfBuffers; }
+
+void AudioOutput::setNumberOfBuffers(const int count) {
+    m_numberOfBuffers = count;
+    reopenStream();
+}
+
+bool AudioOutput::minimizeLatency() const { return m_minimizeLatency; }
+
+void AudioOutput::setMinimizeLatency(const bool minimize) {
+    m_minimizeLatency = minimize;
+    reopenStream();
+}
+
+AudioRouting AudioOutput::routing() const { return m_pendingRouting; }
+
+void AudioOutput::setRouting(const AudioRouting routing) {
+    m_pendingRouting = routing;
+    if (m_resampler.isActive()) {
+        // The resampler converts a fixed number of signals, the fade-out has to play
+        // with the old routing.
+        reopenStream();
+    } else {
+        m_routing = routing;
+    }
+}
+
+int AudioOutput::streamBufferSize() const {
+    return m_audio.isStreamOpen() ? m_streamBufferSize : 0;
+}
+
+Scalar AudioOutput::latency() const {
+    if (!m_audio.isStreamOpen()) {
+        return 0;
+    }
+    return (m_latencyFrames + m_resampler.latency()) / deviceSampleRate();
+}
+
+bool AudioOutput::isLatencyReported() const { return m_isLatencyReported; }
+
+LoadMeter &AudioOutput::callbackLoad() { return m_callbackLoad; }
+
+uint64_t AudioOutput::underflowCount() const { return m_underflows; }
+
+uint64_t AudioOutput::overflowCount() const { return m_overflows; }
+
+void AudioOutput::resetXrunCounts() {
+    m_underflows = 0;
+    m_overflows = 0;
+}
+
 void AudioOutput::openStream() {
     RtAudio::StreamParameters parameters{};
     parameters.deviceId = m_device.ID;
@@ -87,37 +182,155 @@ void AudioOutput::openStream() {
 
     RtAudio::StreamOptions options{};
     options.flags = RTAUDIO_NONINTERLEAVED;
+    if (m_minimizeLatency) {
+        options.flags |= RTAUDIO_MINIMIZE_LATENCY;
+    }
+    options.numberOfBuffers = m_numberOfBuffers;
 
-    unsigned int bufferFrames{1024};
+    // The device may pick another size, larger buffers are split by the callback.
+    unsigned int bufferFrames = m_bufferSize;
     m_audio.openStream(&parameters, nullptr, RTAUDIO_FLOAT32,
                        m_device.preferredSampleRate, &bufferFrames, &streamCallback, this,
                        &options);
+    if (!m_audio.isStreamOpen()) {
+        return;
+    }
+
+    m_streamBufferSize = bufferFrames;
+
+    // Not every API reports it, the buffer itself is the least there is.
+    const long latency = m_audio.getStreamLatency();
+    m_isLatencyReported = (latency > 0);
+    m_latencyFrames = m_isLatencyReported ? latency : bufferFrames;
+
+    std::cout << "AudioOutput: stream opened, " << bufferFrames << " frames per buffer, "
+              << m_latencyFrames << " frames of latency" << std::endl;
+
+    const int renderRate = m_renderSampleRate;
+    const int deviceRate = m_audio.getStreamSampleRate();
+    m_isRenderRateSupported = true;
+    if (renderRate > 0 && renderRate != deviceRate) {
+        // Only resamples aux when it's played.
+        const int signals =
+            (m_routing == AudioRouting_Split && m_device.outputChannels > 1) ? 2 : 1;
+        m_isRenderRateSupported =
+            m_resampler.prepare(renderRate, deviceRate, signals, kMaxBlockSize);
+        if (m_isRenderRateSupported) {
+            std::cout << "AudioOutput: resampling from " << renderRate
+                      << " Hz to " << deviceRate << " Hz" << std::endl;
+        } else {
+            std::cerr << "AudioOutput: can't resample from " << renderRate
+                      << " Hz to " << deviceRate << " Hz, rendering silence" << std::endl;
+        }
+    }
 }
 
-void AudioOutput::closeStream() { m_audio.closeStream(); }
+void AudioOutput::closeStream() {
+    m_audio.closeStream();
+    m_resampler.release();
+}
+
+void AudioOutput::reopenStream() {
+    const bool restart = m_audio.isStreamRunning();
+    if (restart) {
+        stopPlaying();
+    }
+    if (m_audio.isStreamOpen()) {
+        closeStream();
+    }
+
+    // Only now that the time of the stopped stream was taken at the old rate, and its
+    // last buffers were faded out with the old routing.
+    m_renderSampleRate = m_pendingRenderSampleRate;
+    m_routing = m_pendingRouting;
+
+    if (restart) {
+        startPlaying();
+    }
+}
+
+void AudioOutput::fadeOut() {
+    if (!m_audio.isStreamRunning()) {
+        return;
+    }
+    m_fade = Fade_Out;
+
+    // A few buffers at most, give up if the device stalled.
+    using clock = std::chrono::steady_clock;
+    const auto deadline = clock::now() + std::chrono::milliseconds(500);
+    while (m_fade != Fade_Silent && clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
 
 int AudioOutput::streamCallback(void *outputBuffer, void *, unsigned int nBufferFrames,
                                 double streamTime, RtAudioStreamStatus status,
                                 void *userData) {
+    RealtimeAudit::Scope realtime;
+
+    using clock = std::chrono::steady_clock;
+    const auto startTime = clock::now();
+
     auto self = static_cast<AudioOutput *>(userData);
     auto output = static_cast<float *>(outputBuffer);
 
-    const int channels = self->m_device.outputChannels;
+    if (status & RTAUDIO_OUTPUT_UNDERFLOW) {
+        self->m_underflows.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (status & RTAUDIO_INPUT_OVERFLOW) {
+        self->m_overflows.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const int          channels = self->m_device.outputChannels;
+    const AudioRouting routing = self->m_routing.load(std::memory_order_relaxed);
 
-    self->m_buffer.resize(nBufferFrames);
-    bool returnedSomething = self->m_bufferCallback(self->m_buffer);
-    if (returnedSomething) {
-        for (int i = 0; i < nBufferFrames; ++i) {
-            self->m_buffer[i] /= channels;
-        }
-        std::transform(self->m_buffer.begin(), self->m_buffer.end(), &output[0],
-                       [](const Scalar x) { return (float)x; });
-        for (int c = 1; c < channels; ++c) {
-            std::copy(&output[0], &output[nBufferFrames], &output[c * nBufferFrames]);
+    const int fadeState = self->m_fade.load(std::memory_order_acquire);
+    if (fadeState == Fade_Silent) {
+        std::fill(output, output + channels * nBufferFrames, 0.0f);
+        return 0;
+    }
+
+    // Ramp over the whole buffer when fading, fade + i * fadeStep at frame i.
+    Scalar fade = 1;
+    Scalar fadeStep = 0;
+    if (fadeState == Fade_In) {
+        fade = 0;
+        fadeStep = 1.0_f / nBufferFrames;
+    } else if (fadeState == Fade_Out) {
+        fade = 1 - 1.0_f / nBufferFrames;
+        fadeStep = -1.0_f / nBufferFrames;
+    }
+
+    const bool isResampling = self->m_resampler.isActive();
+    const bool isSilent = !self->m_isRenderRateSupported;
+
+    for (int start = 0; start < nBufferFrames; start += kMaxBlockSize) {
+        AudioBlock block{};
+        block.length = std::min<int>(nBufferFrames - start, kMaxBlockSize);
+        block.mainGain = 1;
+        block.auxGain = 1;
+        if (isResampling) {
+            self->m_resampler.process(block, self->m_renderBlock);
+        } else if (isSilent || !self->m_renderBlock(block)) {
+            block.main = nullptr;
+            block.aux = nullptr;
         }
+
+        // Gain, fade, conversion and fan-out in one pass per channel.
+        writeAudioBlock(block, routing, fade + start * fadeStep, fadeStep, &output[start],
+                        channels, nBufferFrames);
+    }
+
+    if (fadeState != Fade_None) {
+        int expected = fadeState;
+        self->m_fade.compare_exchange_strong(
+            expected, fadeState == Fade_In ? Fade_None : Fade_Silent,
+            std::memory_order_release);
     }
 
-    self->m_time += nBufferFrames;
+    const std::chrono::duration<double, std::nano> elapsed = clock::now() - startTime;
+    const double duration = 1e9 * nBufferFrames / self->m_audio.getStreamSampleRate();
+    self->m_callbackLoad.record(elapsed.count(), duration);
 
     return 0;
 }
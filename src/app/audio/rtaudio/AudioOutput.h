@@ -10,12 +10,19 @@
 #include <queue>
 #include <vector>
 
+#include "../AudioBlock.h"
 #include "../AudioTime.h"
+#include "../LoadMeter.h"
+#include "../OutputResampler.h"
 #include "AudioDevices.h"
 
 class AudioOutput : public AudioTime {
    public:
-    using BufferCallback = std::function<bool(std::vector<Scalar> &)>;
+    // Points the block at the rendered signals, returns false for silence.
+    using BufferCallback = std::function<bool(AudioBlock &)>;
+
+    // The callback never gets longer blocks, longer device buffers are split.
+    static constexpr int kMaxBlockSize = 4096;
 
     AudioOutput(RtAudio &audio);
     ~AudioOutput();
@@ -28,13 +35,64 @@ class AudioOutput : public AudioTime {
 
     bool isPlaying() const;
 
+    // Rate of the blocks the callback renders, the engine's.
     Scalar   sampleRate() const;
     Scalar   time(int sampleOffset) const override;
     uint64_t timeSamples(int sampleOffset) const override;
 
+    // Stream settings, changing one reopens the stream (faded out and back in).
+    int  bufferSize() const;  // Frames per callback requested from the device.
+    void setBufferSize(int frames);
+    int  numberOfBuffers() const;  // 0 lets the API choose. DirectSound, OSS and ALSA.
+    void setNumberOfBuffers(int count);
+    bool minimizeLatency() const;
+    void setMinimizeLatency(bool minimize);
+
+    // Renders at this fixed rate and resamples to the device's, or at the device's rate
+    // if 0. Changing it reopens the stream, the engine then needs the new sampleRate().
+    int  renderSampleRate() const;
+    void setRenderSampleRate(int rate);
+
+    // Rate of the open stream, or the one it will open with.
+    Scalar deviceSampleRate() const;
+    bool   isResampling() const;
+
+    // Which channels the signals of each block go to, applies from the next callback.
+    // While resampling, splitting needs another resampled signal and reopens the
+    // stream.
+    AudioRouting routing() const;
+    void         setRouting(AudioRouting routing);
+
+    // Frames per callback the open stream actually uses, 0 if closed.
+    int streamBufferSize() const;
+
+    // As reported by RtAudio, or one buffer if the API doesn't report it. Includes the
+    // resampler's delay.
+    Scalar latency() const override;
+    bool   isLatencyReported() const;
+
+    // Load of the whole callback.
+    LoadMeter& callbackLoad();
+
+    // Callbacks the device flagged as late (output) or lost input for.
+    uint64_t underflowCount() const;
+    uint64_t overflowCount() const;
+    void     resetXrunCounts();
+
    private:
+    enum Fade {
+        Fade_None,
+        Fade_In,      // Over the next callback, then Fade_None.
+        Fade_Out,     // Over the next callback, then Fade_Silent.
+        Fade_Silent,  // Until the stream is started again.
+    };
+
     void openStream();
     void closeStream();
+    void reopenStream();
+
+    // Waits for the callback to fade to silence, so that stopping doesn't click.
+    void fadeOut();
 
     static int streamCallback(void *outputBuffer, void *, unsigned int nBufferFrames,
                               double streamTime, RtAudioStreamStatus status,
@@ -43,11 +101,38 @@ class AudioOutput : public AudioTime {
     RtAudio            &m_audio;
     RtAudio::DeviceInfo m_device;
 
-    BufferCallback      m_bufferCallback;
-    std::vector<Scalar> m_buffer;
+    int  m_bufferSize;
+    int  m_numberOfBuffers;
+    bool m_minimizeLatency;
+    int  m_pendingRenderSampleRate;  // Applied by reopenStream().
+
+    // Read by the audio thread through time(), only changes while the stream is closed.
+    std::atomic_int m_renderSampleRate;
+
+    int  m_streamBufferSize;
+    long m_latencyFrames;
+    bool m_isLatencyReported;
+
+    std::atomic_int m_fade;
+
+    // While resampling, a new routing waits in m_pendingRouting for reopenStream().
+    std::atomic<AudioRouting> m_routing;
+    AudioRouting              m_pendingRouting;
+
+    BufferCallback m_bufferCallback;
+    BufferCallback m_renderBlock;  // m_bufferCallback, then advances the time.
+
+    // Prepared only while resampling. Fails for rates speex can't convert between,
+    // the stream then plays silence.
+    OutputResampler m_resampler;
+    bool            m_isRenderRateSupported;
 
     std::atomic<Scalar>  m_timeOffset;
     std::atomic_uint64_t m_time;
+
+    LoadMeter            m_callbackLoad;
+    std::atomic_uint64_t m_underflows;
+    std::atomic_uint64_t m_overflows;
 };
 
 #endif  // SOURCEMODEL__PORTAUDIO_AUDIOOUTPUT_H
\ No newline at end of file
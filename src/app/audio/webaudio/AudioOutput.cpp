@@ -2,10 +2,19 @@
 
 #include <SDL.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
+#include "../RealtimeAudit.h"
+
 AudioOutput::AudioOutput()
-    : m_audioDevice(0), m_sampleRate(48000), m_isPlaying(false), m_time(0) {
+    : m_audioDevice(0),
+      m_sampleRate(48000),
+      m_bufferSize(2048),
+      m_streamBufferSize(0),
+      m_isPlaying(false),
+      m_time(0) {
     if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
         std::cerr << "SDL2 Audio init failed: " << SDL_GetError() << std::endl;
     }
@@ -31,7 +40,7 @@ void AudioOutput::startPlaying() {
         // Relatively high buffer length on web because
         // processing latency with short buffers is really big.
         // Set a high buffer length to avoid constant buffer underruns
-        desiredSpec.samples = 2048;
+        desiredSpec.samples = m_bufferSize;
         desiredSpec.callback = &audioCallback;
         desiredSpec.userdata = this;
 
@@ -39,6 +48,7 @@ void AudioOutput::startPlaying() {
             SDL_OpenAudioDevice(nullptr, SDL_FALSE, &desiredSpec, &desiredSpec,
                                 SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
         m_sampleRate = desiredSpec.freq;
+        m_streamBufferSize = desiredSpec.samples;
     }
     SDL_PauseAudioDevice(m_audioDevice, SDL_FALSE);
     m_isPlaying = true;
@@ -53,6 +63,8 @@ bool AudioOutput::isPlaying() const { return m_isPlaying; }
 
 Scalar AudioOutput::sampleRate() const { return m_sampleRate; }
 
+Scalar AudioOutput::deviceSampleRate() const { return m_sampleRate; }
+
 Scalar AudioOutput::time(const int sampleOffset) const {
     return (sampleOffset + m_time) / m_sampleRate;
 }
@@ -61,16 +73,64 @@ uint64_t AudioOutput::timeSamples(const int sampleOffset) const {
     return sampleOffset + m_time;
 }
 
+int AudioOutput::bufferSize() const { return m_bufferSize; }
+
+void AudioOutput::setBufferSize(const int frames) {
+    m_bufferSize = frames;
+
+    // SDL can't resize the buffer of an open device, open a new one.
+    if (m_audioDevice != 0) {
+        const bool restart = m_isPlaying;
+        SDL_CloseAudioDevice(m_audioDevice);
+        m_audioDevice = 0;
+        if (restart) {
+            startPlaying();
+        }
+    }
+}
+
+int AudioOutput::streamBufferSize() const {
+    return (m_audioDevice != 0) ? m_streamBufferSize : 0;
+}
+
+Scalar AudioOutput::latency() const {
+    return (m_audioDevice != 0) ? m_streamBufferSize / m_sampleRate : 0;
+}
+
+bool AudioOutput::isLatencyReported() const { return false; }
+
+LoadMeter& AudioOutput::callbackLoad() { return m_callbackLoad; }
+
+uint64_t AudioOutput::underflowCount() const { return 0; }
+
+uint64_t AudioOutput::overflowCount() const { return 0; }
+
+void AudioOutput::resetXrunCounts() {}
+
 void AudioOutput::audioCallback(void* userdata, Uint8* stream, int lenBytes) {
+    RealtimeAudit::Scope realtime;
+
+    using clock = std::chrono::steady_clock;
+    const auto startTime = clock::now();
+
     auto      self = static_cast<AudioOutput*>(userdata);
     auto      output = reinterpret_cast<float*>(stream);
     const int frameCount = lenBytes / sizeof(float);
 
-    self->m_buffer.resize(frameCount);
-    bool returnedSomething = self->m_bufferCallback(self->m_buffer);
-    if (returnedSomething) {
-        std::copy(self->m_buffer.begin(), self->m_buffer.end(), output);
+    for (int start = 0; start < frameCount; start += kMaxBlockSize) {
+        AudioBlock block{};
+        block.length = std::min(frameCount - start, kMaxBlockSize);
+        block.mainGain = 1;
+        block.auxGain = 1;
+        if (!self->m_bufferCallback(block)) {
+            block.main = nullptr;
+        }
+
+        writeAudioBlock(block, AudioRouting_Mono, 1, 0, &output[start], 1, frameCount);
+
+        self->m_time += block.length;
     }
 
-    self->m_time += frameCount;
+    const std::chrono::duration<double, std::nano> elapsed = clock::now() - startTime;
+    self->m_callbackLoad.record(elapsed.count(), 1e9 * frameCount / self->m_sampleRate);
 }
\ No newline at end of file
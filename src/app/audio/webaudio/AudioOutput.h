@@ -8,11 +8,18 @@
 #include <functional>
 #include <vector>
 
+#include "../AudioBlock.h"
 #include "../AudioTime.h"
+#include "../LoadMeter.h"
 
 class AudioOutput : public AudioTime {
    public:
-    using BufferCallback = std::function<bool(std::vector<Scalar> &)>;
+    // Points the block at the rendered signals, returns false for silence. The device
+    // is mono, only the main signal is played.
+    using BufferCallback = std::function<bool(AudioBlock &)>;
+
+    // The callback never gets longer blocks, longer device buffers are split.
+    static constexpr int kMaxBlockSize = 4096;
 
     AudioOutput();
     ~AudioOutput();
@@ -24,22 +31,46 @@ class AudioOutput : public AudioTime {
 
     bool isPlaying() const;
 
+    // Always the same, the web backend renders at the rate of the device.
     Scalar   sampleRate() const;
+    Scalar   deviceSampleRate() const;
     Scalar   time(int sampleOffset) const override;
     uint64_t timeSamples(int sampleOffset) const override;
 
+    // Frames per callback requested from SDL, changing it reopens the device.
+    int  bufferSize() const;
+    void setBufferSize(int frames);
+
+    // Frames per callback the open device actually uses, 0 if closed.
+    int streamBufferSize() const;
+
+    // One buffer, SDL doesn't report what the browser adds.
+    Scalar latency() const override;
+    bool   isLatencyReported() const;
+
+    // Load of the whole callback.
+    LoadMeter& callbackLoad();
+
+    // SDL doesn't report xruns, these are always 0.
+    uint64_t underflowCount() const;
+    uint64_t overflowCount() const;
+    void     resetXrunCounts();
+
    private:
     static void audioCallback(void *userdata, Uint8 *stream, int len);
 
     SDL_AudioDeviceID m_audioDevice;
     Scalar            m_sampleRate;
+    int               m_bufferSize;
+    int               m_streamBufferSize;
 
     bool m_isPlaying;
 
-    BufferCallback      m_bufferCallback;
-    std::vector<Scalar> m_buffer;
+    BufferCallback m_bufferCallback;
 
     std::atomic_uint64_t m_time;
+
+    LoadMeter m_callbackLoad;
 };
 
 #endif  // SOURCEMODEL__WEBAUDIO_AUDIOOUTPUT_H
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef SOURCEMODEL__BENCH_BENCHMARK_H
+#define SOURCEMODEL__BENCH_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+/* Minimal benchmark registry for the engine, no external framework.
+ *
+ * Each benchmark is a plain function registered under a name with
+ * SOURCEMODEL_BENCHMARK, and prints its own results (timings and, where it makes
+ * sense, accuracy against a reference). Accuracy that must not regress goes through
+ * check().
+ */
+namespace bench {
+
+struct Benchmark {
+    std::string           name;
+    std::function<void()> run;
+};
+
+std::vector<Benchmark>& registry();
+
+struct Registration {
+    Registration(const char* name, void (*run)()) { registry().push_back({name, run}); }
+};
+
+// Keeps the compiler from optimizing away a computed value.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+// Nanoseconds per call of fn, best of a few repetitions of `iterations` calls. The
+// first repetition only warms up the caches and the clock speed, and isn't counted.
+template <typename Fn>
+double timeNs(const int iterations, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+
+    double best = std::numeric_limits<double>::max();
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        const auto start = clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            fn();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+        best = std::min(best, elapsed.count() / iterations);
+    }
+    return best;
+}
+
+void printTime(const char* label, double ns, const char* unit = "call");
+
+// Accuracy checks. A failed one is reported, and the run exits with a non-zero status.
+bool check(bool condition, const char* what);
+int  failureCount();
+
+}  // namespace bench
+
+#define SOURCEMODEL_BENCHMARK_CONCAT_(a, b) a##b
+#define SOURCEMODEL_BENCHMARK_CONCAT(a, b) SOURCEMODEL_BENCHMARK_CONCAT_(a, b)
+
+// Defines and registers a benchmark: SOURCEMODEL_BENCHMARK("name") { ... }
+#define SOURCEMODEL_BENCHMARK(name)                                                  \
+    static void SOURCEMODEL_BENCHMARK_CONCAT(benchmark_, __LINE__)();                \
+    static const bench::Registration SOURCEMODEL_BENCHMARK_CONCAT(registration_,     \
+                                                                  __LINE__)(         \
+        name, SOURCEMODEL_BENCHMARK_CONCAT(benchmark_, __LINE__));                   \
+    static void SOURCEMODEL_BENCHMARK_CONCAT(benchmark_, __LINE__)()
+
+#endif  // SOURCEMODEL__BENCH_BENCHMARK_H
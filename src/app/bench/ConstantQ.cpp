@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ConstantQSpectrum.h"
+#include "GeneratorSpectrum.h"
+#include "audio/BufferedGenerator.h"
+#include "audio/SampleClock.h"
+
+namespace {
+constexpr Scalar kSampleRate = 48000;
+constexpr Scalar kF0 = 110;
+constexpr int    kBlockSize = 800;  // One block per frame at 60 fps.
+
+// Harmonics of kF0 with 1/k amplitudes, like a very bright glottal source.
+class HarmonicGenerator : public BufferedGenerator {
+   public:
+    using BufferedGenerator::BufferedGenerator;
+
+   protected:
+    void fillInternalBuffer(std::vector<Scalar>& out) override {
+        for (auto& x : out) {
+            x = 0;
+            for (int k = 1; k * kF0 < kSampleRate / 2; ++k) {
+                x += std::sin(2 * Scalar(M_PI) * k * kF0 * m_n / kSampleRate) / k;
+            }
+            m_n++;
+        }
+    }
+
+   private:
+    int64_t m_n = 0;
+};
+
+// Level of a spectrum at f, linearly interpolated between its points.
+Scalar levelAt(const Scalar* freqs, const Scalar* levels, const int count,
+               const Scalar f) {
+    int i = 1;
+    while (i < count - 1 && freqs[i] < f) ++i;
+    const Scalar w = (f - freqs[i - 1]) / (freqs[i] - freqs[i - 1]);
+    return (1 - w) * levels[i - 1] + w * levels[i];
+}
+
+// Harmonic k against the valley just above it, in dB.
+template <typename Spectrum>
+void printContrast(const char* label, const Spectrum& spectrum) {
+    std::printf("  %-18s", label);
+    for (int k = 1; k <= 6; ++k) {
+        const Scalar peak = levelAt(spectrum.frequencies(), spectrum.magnitudesDb(),
+                                    spectrum.binCount(), k * kF0);
+        const Scalar valley = levelAt(spectrum.frequencies(), spectrum.magnitudesDb(),
+                                      spectrum.binCount(), (k + 0.5) * kF0);
+        std::printf(" %5.1f", peak - valley);
+    }
+    std::printf("\n");
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("constant-q") {
+    using clock = std::chrono::steady_clock;
+
+    SampleClock         time(kSampleRate);
+    HarmonicGenerator   generator(time);
+    GeneratorSpectrum   fft(&generator);
+    ConstantQSpectrum   constantQ(&generator);
+    std::vector<Scalar> block(kBlockSize);
+
+    generator.setSampleRate(kSampleRate);
+    generator.setNormalized(false);
+    fft.setSampleRate(kSampleRate);
+    fft.setResponseTime(0.00125);
+    fft.setTransformSize(1024);
+    constantQ.setSampleRate(kSampleRate);
+    constantQ.setFrequencyScale(FrequencyScale_Mel);
+
+    std::printf(" %d bands, %.0f ms behind the output\n", constantQ.bandCount(),
+                1000 * constantQ.latency());
+
+    std::chrono::duration<double, std::nano> fftTime(0);
+    std::chrono::duration<double, std::nano> constantQTime(0);
+
+    // Two seconds, so that even the lowest bands have settled.
+    constexpr int blockCount = 2 * kSampleRate / kBlockSize;
+    for (int b = 0; b < blockCount; ++b) {
+        generator.fillBuffer(block);
+        time.advance(kBlockSize);
+
+        auto start = clock::now();
+        fft.update();
+        fftTime += clock::now() - start;
+
+        start = clock::now();
+        constantQ.update();
+        constantQTime += clock::now() - start;
+    }
+
+    std::printf(" Harmonic to valley contrast in dB, harmonics 1 to 6 of %.0f Hz:\n",
+                kF0);
+    printContrast("FFT 1024", fft);
+    printContrast("constant-Q", constantQ);
+
+    bench::printTime("FFT 1024 update", fftTime.count() / blockCount, "frame");
+    bench::printTime("constant-Q update", constantQTime.count() / blockCount, "frame");
+}
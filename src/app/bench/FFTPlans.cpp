@@ -0,0 +1,53 @@
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <fftw3cxx.hh>
+#include <random>
+
+#include "Benchmark.h"
+#include "math/FFTPlanCache.h"
+#include "math/utils.h"
+
+namespace {
+// Time of one forward r2c transform of n samples with a plan made with flags.
+double transformNs(const int n, const unsigned flags) {
+    Scalar* in = static_cast<Scalar*>(fftw3cxx::malloc<Scalar>(n * sizeof(Scalar)));
+    auto*   out = static_cast<std::complex<Scalar>*>(
+        fftw3cxx::malloc<Scalar>((n / 2 + 1) * sizeof(std::complex<Scalar>)));
+
+    auto plan = fftw3cxx::plan<Scalar>::plan_dft_r2c_1d(n, in, out, flags);
+
+    std::mt19937                           rng(42);
+    std::uniform_real_distribution<Scalar> noise(-1, 1);
+    for (int i = 0; i < n; ++i) in[i] = noise(rng);
+
+    const double ns = bench::timeNs(200, [&] {
+        plan.execute_dft_r2c(in, out);
+        bench::doNotOptimize(out[0]);
+    });
+
+    fftw3cxx::free<Scalar>(in);
+    fftw3cxx::free<Scalar>(out);
+    return ns;
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("fft-plans") {
+    for (const int n : {4096, 8192, 16384, 32768}) {
+        std::printf(" %d points:\n", n);
+        bench::printTime("  execute, FFTW_ESTIMATE", transformNs(n, FFTW_ESTIMATE));
+        bench::printTime("  execute, FFTW_MEASURE", transformNs(n, FFTW_MEASURE));
+    }
+
+    // The first plan of a size runs the planner, later ones come from the cache.
+    using clock = std::chrono::steady_clock;
+    auto&      cache = FFTPlanCache<Scalar>::instance();
+    const auto start = clock::now();
+    cache.realForward(12000);
+    const std::chrono::duration<double, std::nano> cold = clock::now() - start;
+    bench::printTime("plan 12000 points, planner", cold.count());
+    bench::printTime("plan 12000 points, cached", bench::timeNs(1'000, [&] {
+                         auto plan = cache.realForward(12000);
+                         bench::doNotOptimize(plan);
+                     }));
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.h"
+#include "FilterSpectrum.h"
+#include "FormantFilterBank.h"
+
+namespace {
+using Section = std::array<Scalar, 6>;
+
+constexpr int    kNumFormants = 5;
+constexpr Scalar kSampleRate = 48000;
+constexpr int    kNfft = 4096;
+
+constexpr std::array<Scalar, kNumFormants> kF = {800, 1150, 2900, 3900, 4650};
+constexpr std::array<Scalar, kNumFormants> kB = {80, 90, 120, 130, 140};
+
+// Response of sections at bin i, summed if parallel or multiplied if not.
+std::complex<Scalar> exactResponse(const std::vector<Section>& sos, const int i,
+                                   const bool parallel) {
+    const std::complex<Scalar> z1 = std::polar(Scalar(1), -2 * Scalar(M_PI) * i / kNfft);
+    const std::complex<Scalar> z2 = z1 * z1;
+
+    std::complex<Scalar> H = parallel ? 0 : 1;
+    for (const auto& s : sos) {
+        const std::complex<Scalar> Hs =
+            (s[0] + s[1] * z1 + s[2] * z2) / (s[3] + s[4] * z1 + s[5] * z2);
+        H = parallel ? H + Hs : H * Hs;
+    }
+    return H;
+}
+
+// Largest level difference in dB between magnitudes and the exact response of the
+// branches (in parallel) in cascade with the series sections.
+Scalar maxErrorDb(const Scalar* mags, const std::vector<Section>& series,
+                  const std::vector<Section>& branches = {}) {
+    Scalar error = 0;
+    for (int i = 0; i < kNfft / 2 + 1; ++i) {
+        std::complex<Scalar> H = exactResponse(series, i, false);
+        if (!branches.empty()) {
+            H *= exactResponse(branches, i, true);
+        }
+        error = std::max(error, std::abs(20 * std::log10(mags[i] / std::abs(H))));
+    }
+    return error;
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("filter-spectrum") {
+    FormantFilterBank bank(kNumFormants, kSampleRate);
+    for (int k = 0; k < kNumFormants; ++k) {
+        bank.setFormant(k, kF[k], kB[k]);
+    }
+    bank.update();
+
+    // Same formant sections as FormantGenerator::updateSpectrum, and a lip radiation
+    // first difference so that every section has a non-trivial response.
+    constexpr Scalar     d = 0.99;
+    std::vector<Section> sos;
+    for (int k = 0; k < kNumFormants; ++k) {
+        sos.push_back(bank.biquadCoefficients(k));
+    }
+    sos.push_back({1 / (1 - d), -d / (1 - d), 0, 1, 0, 0});
+
+    FilterSpectrum spectrum;
+    spectrum.setSize(kNfft);
+    spectrum.update(sos);
+
+    std::printf(" Max error against the exact response: %.1e dB\n",
+                maxErrorDb(spectrum.magnitudes(), sos));
+
+    FormantFilterBank parallel = bank;
+    parallel.setTopology(FormantFilterBank::Topology_Parallel);
+    parallel.update();
+    std::vector<Section> branches;
+    for (int k = 0; k < kNumFormants; ++k) {
+        branches.push_back(parallel.biquadCoefficients(k));
+    }
+    FilterSpectrum parallelSpectrum;
+    parallelSpectrum.setSize(kNfft);
+    parallelSpectrum.updateParallel(branches, sos.back());
+    std::printf(" Max error against the exact parallel response: %.1e dB\n",
+                maxErrorDb(parallelSpectrum.magnitudes(), {sos.back()}, branches));
+
+    // Alternate between two sets of coefficients so that every update recomputes.
+    std::vector<Section> other = sos;
+    for (auto& sec : other) sec[0] *= 2;
+
+    bool flip = false;
+    bench::printTime("6 sections, analytic", bench::timeNs(1'000, [&] {
+                         spectrum.update((flip = !flip) ? other : sos);
+                         bench::doNotOptimize(spectrum.magnitudes()[0]);
+                     }));
+
+    // Only the first formant moves, like a glide of F1.
+    std::vector<Section> glide = sos;
+    glide[0][0] *= 2;
+    bench::printTime("6 sections, analytic, 1 changed", bench::timeNs(1'000, [&] {
+                         spectrum.update((flip = !flip) ? glide : sos);
+                         bench::doNotOptimize(spectrum.magnitudes()[0]);
+                     }));
+    bench::printTime("6 sections, analytic, unchanged", bench::timeNs(1'000, [&] {
+                         spectrum.update(sos);
+                         bench::doNotOptimize(spectrum.magnitudes()[0]);
+                     }));
+
+    std::vector<Section> otherBranches = branches;
+    for (auto& sec : otherBranches) sec[0] *= 2;
+    bench::printTime("5 branches + 1 section, analytic", bench::timeNs(1'000, [&] {
+                         parallelSpectrum.updateParallel(
+                             (flip = !flip) ? otherBranches : branches, sos.back());
+                         bench::doNotOptimize(parallelSpectrum.magnitudes()[0]);
+                     }));
+}
@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.h"
+#include "FormantGenerator.h"
+#include "GlottalFlow.h"
+#include "SourceGenerator.h"
+#include "audio/AudioBlock.h"
+#include "audio/OutputResampler.h"
+#include "audio/SampleClock.h"
+
+namespace {
+constexpr int    kBlockSize = 512;  // Device frames per callback.
+constexpr double kSeconds = 2;
+
+// The app's callback chain at renderRate, for a device at deviceRate. Returns the
+// nanoseconds it takes per second of output.
+double runChain(const int renderRate, const int deviceRate) {
+    using clock = std::chrono::steady_clock;
+
+    SampleClock         time(renderRate);
+    GlottalFlow         glottalFlow;
+    SourceGenerator     source(time, glottalFlow);
+    std::vector<Scalar> intermediate;
+    FormantGenerator    formants(time, intermediate);
+    std::vector<Scalar> filtered;
+
+    glottalFlow.parameters().Rd.valueChanged.connect(&SourceGenerator::handleParamChanged,
+                                                     &source);
+    glottalFlow.setSampleCount(1024);
+    glottalFlow.setModelType(GlottalFlowModel_LF);
+    glottalFlow.parameters().setUsingRd(true);
+    glottalFlow.parameters().Rd.setValue(1.0);
+
+    source.pitch().setValue(110);
+    source.setSampleRate(renderRate);
+    source.setNormalized(true);
+    formants.setSampleRate(renderRate);
+    formants.setNormalized(false);
+    source.prepare(4096);
+    formants.prepare(4096);
+
+    const OutputResampler::RenderCallback render = [&](AudioBlock& block) {
+        intermediate.resize(block.length);
+        filtered.resize(block.length);
+        source.fillBuffer(intermediate);
+        formants.fillBuffer(filtered);
+        time.advance(block.length);
+        block.main = &filtered;
+        block.aux = &intermediate;
+        return true;
+    };
+
+    OutputResampler resampler;
+    if (renderRate != deviceRate) {
+        resampler.prepare(renderRate, deviceRate, 1, 4096);
+    }
+
+    std::vector<float> output(2 * kBlockSize);
+    const int          blockCount = kSeconds * deviceRate / kBlockSize;
+
+    const auto start = clock::now();
+    for (int b = 0; b < blockCount; ++b) {
+        AudioBlock block{};
+        block.length = kBlockSize;
+        if (resampler.isActive()) {
+            resampler.process(block, render);
+        } else {
+            render(block);
+        }
+        writeAudioBlock(block, AudioRouting_Mono, 1, 0, output.data(), 2, kBlockSize);
+        bench::doNotOptimize(output[0]);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+
+    return elapsed.count() / kSeconds;
+}
+
+// A unit sine through the resampler, returns the RMS of what isn't that sine at the
+// output (noise and distortion), past the filter's start.
+double sineResidual(const int renderRate, const int deviceRate, const double frequency) {
+    OutputResampler resampler;
+    resampler.prepare(renderRate, deviceRate, 1, 4096);
+
+    std::vector<Scalar> sine;
+    uint64_t            rendered = 0;
+
+    const OutputResampler::RenderCallback render = [&](AudioBlock& block) {
+        sine.resize(block.length);
+        for (int i = 0; i < block.length; ++i) {
+            sine[i] = std::sin(2 * M_PI * frequency * (rendered + i) / renderRate);
+        }
+        rendered += block.length;
+        block.main = &sine;
+        return true;
+    };
+
+    constexpr int       kSkip = 4 * kBlockSize;
+    std::vector<double> y;
+    for (int b = 0; b < 200; ++b) {
+        AudioBlock block{};
+        block.length = kBlockSize;
+        resampler.process(block, render);
+        if (b * kBlockSize >= kSkip) {
+            y.insert(y.end(), block.main->begin(), block.main->end());
+        }
+    }
+
+    // Least-squares fit of the sine, whatever its phase after the filter's delay.
+    const double w = 2 * M_PI * frequency / deviceRate;
+    double       a = 0;
+    double       c = 0;
+    for (int n = 0; n < int(y.size()); ++n) {
+        a += y[n] * std::sin(w * n);
+        c += y[n] * std::cos(w * n);
+    }
+    a *= 2.0 / y.size();
+    c *= 2.0 / y.size();
+
+    double residual = 0;
+    for (int n = 0; n < int(y.size()); ++n) {
+        residual += std::pow(y[n] - a * std::sin(w * n) - c * std::cos(w * n), 2);
+    }
+    return std::sqrt(residual / y.size());
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("fixed-rate") {
+    std::printf(" Source and formants, per second of output:\n");
+    for (const int deviceRate : {44100, 48000, 96000, 192000}) {
+        char label[48];
+        std::snprintf(label, sizeof(label), "%d Hz, native", deviceRate);
+        bench::printTime(label, runChain(deviceRate, deviceRate), "s");
+        if (deviceRate != 48000) {
+            std::snprintf(label, sizeof(label), "%d Hz, from 48 kHz", deviceRate);
+            bench::printTime(label, runChain(48000, deviceRate), "s");
+        }
+    }
+
+    std::printf(" Residual of a resampled unit sine:\n");
+    for (const int deviceRate : {44100, 96000, 192000}) {
+        for (const double frequency : {1000, 15000}) {
+            std::printf("  48000 -> %6d Hz, %5.0f Hz: %.1e\n", deviceRate, frequency,
+                        sineResidual(48000, deviceRate, frequency));
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <boost/math/quadrature/gauss_kronrod.hpp>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "Benchmark.h"
+#include "GlottalFlowParameters.h"
+#include "math/CumulativeIntegral.h"
+#include "models/LF.h"
+#include "models/RPlusPlus.h"
+#include "models/RosenbergC.h"
+
+using namespace boost::math::quadrature;
+
+namespace {
+// The plot grid of GlottalFlow::updateSamples, with Te snapped onto it.
+std::vector<Scalar> plotTimes(const int n, const Scalar Te) {
+    std::vector<Scalar> t(n);
+    for (int i = 0; i < n; ++i) {
+        t[i] = i / Scalar(n);
+        if (i > 0 && t[i - 1] < Te && Te < t[i]) {
+            t[i - 1] = Te;
+        }
+    }
+    return t;
+}
+
+void integrate(const GlottalFlowModel& model, const std::vector<Scalar>& t,
+               std::vector<Scalar>& g, std::vector<Scalar>& nodes,
+               std::vector<Scalar>& values) {
+    const auto evaluateBlock = [&model](const Scalar* x, Scalar* y, const int n) {
+        model.evaluateBlock(x, y, n);
+    };
+    cumulativeIntegral(evaluateBlock, 0, t.data(), g.data(), int(t.size()), nodes,
+                       values);
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("flow-integration") {
+    // Compared against the closed-form antiderivatives. KLGLOTT88 is left out, its
+    // evaluateAntiderivative is scaled by 1 / Oq compared to the integral of evaluate.
+    std::vector<std::unique_ptr<GlottalFlowModel>> models;
+    models.push_back(std::make_unique<models::LF>());
+    models.push_back(std::make_unique<models::RPlusPlus>());
+    models.push_back(std::make_unique<models::RosenbergC>());
+
+    std::vector<Scalar> nodes, values;
+
+    std::printf(" Max error of the cumulative integral, relative to max |g|:\n");
+    const char* name = GlottalFlowModel_NAMES;
+    for (const auto& model : models) {
+        GlottalFlowParameters params;
+        params.setUsingRd(false);
+        model->updateParameterBounds(params);
+        model->fitParameters(params);
+
+        std::printf("  %-12s", name);
+        for (const int n : {256, 1024, 4096}) {
+            const auto          t = plotTimes(n, params.Oq.value());
+            std::vector<Scalar> g(n);
+            integrate(*model, t, g, nodes, values);
+
+            Scalar scale = 0;
+            Scalar error = 0;
+            for (int i = 0; i < n; ++i) {
+                const Scalar reference = model->evaluateAntiderivative(t[i]);
+                scale = std::max(scale, std::abs(reference));
+                error = std::max(error, std::abs(g[i] - reference));
+            }
+            std::printf("  N=%d %.1e", n, error / scale);
+        }
+        std::printf("\n");
+
+        name += std::char_traits<char>::length(name) + 1;
+    }
+
+    const GlottalFlowModel& lf = *models[0];
+    for (const int n : {1024, 8192}) {
+        const auto          t = plotTimes(n, Scalar(0.6));
+        std::vector<Scalar> g(n);
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "cumulative, N=%d", n);
+        bench::printTime(label, bench::timeNs(100, [&] {
+                             integrate(lf, t, g, nodes, values);
+                             bench::doNotOptimize(g[n - 1]);
+                         }),
+                         "curve");
+    }
+
+    // What updateSamples used to do: one adaptive integral from 0 per sample.
+    {
+        constexpr int n = 1024;
+        const auto    t = plotTimes(n, Scalar(0.6));
+        const auto    fn = [&lf](double x) -> double { return lf.evaluate(x); };
+        bench::printTime("adaptive per sample, N=1024", bench::timeNs(1, [&] {
+                             for (int i = 0; i < n; ++i) {
+                                 const double g = gauss_kronrod<double, 31>::integrate(
+                                     fn, 0, t[i], 15, 1e-6);
+                                 bench::doNotOptimize(g);
+                             }
+                         }),
+                         "curve");
+    }
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "FormantFilterBank.h"
+#include "OneFormantFilter.h"
+
+namespace {
+constexpr int    kNumFormants = 5;
+constexpr Scalar kSampleRate = 48000;
+
+constexpr std::array<Scalar, kNumFormants> kF = {800, 1150, 2900, 3900, 4650};
+constexpr std::array<Scalar, kNumFormants> kB = {80, 90, 120, 130, 140};
+
+// Response of the bank at f, from its sections.
+std::complex<Scalar> response(const FormantFilterBank& bank, const Scalar f) {
+    const Scalar               omega = 2 * Scalar(M_PI) * f / kSampleRate;
+    const std::complex<Scalar> z1 = std::polar(Scalar(1), -omega);
+    const std::complex<Scalar> z2 = z1 * z1;
+
+    const bool parallel = bank.topology() == FormantFilterBank::Topology_Parallel;
+
+    std::complex<Scalar> H = parallel ? 0 : 1;
+    for (int k = 0; k < bank.formantCount(); ++k) {
+        const auto                 c = bank.biquadCoefficients(k);
+        const std::complex<Scalar> Hk = (c[0] + c[1] * z1 + c[2] * z2) /
+                                        (c[3] + c[4] * z1 + c[5] * z2);
+        H = parallel ? H + Hk : H * Hk;
+    }
+    return H;
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("formant-filter-bank") {
+    constexpr int numSamples = 4096;
+
+    std::mt19937                           rng(42);
+    std::uniform_real_distribution<Scalar> noise(-1, 1);
+
+    std::vector<Scalar> x(numSamples);
+    for (auto& xi : x) xi = noise(rng);
+
+    std::vector<Scalar> y(numSamples);
+    std::vector<Scalar> yReference(numSamples);
+
+    std::array<OneFormantFilter, kNumFormants> filters;
+    FormantFilterBank                          bank(kNumFormants, kSampleRate);
+    for (int k = 0; k < kNumFormants; ++k) {
+        filters[k].setFrequency(kF[k]);
+        filters[k].setBandwidth(kB[k]);
+        filters[k].update();
+        bank.setFormant(k, kF[k], kB[k]);
+    }
+    bank.update();
+
+    // The cascade is the same filter as OneFormantFilter in series, up to rounding.
+    for (int i = 0; i < numSamples; ++i) {
+        Scalar yi = x[i];
+        for (auto& filter : filters) yi = filter.tick(yi);
+        yReference[i] = yi;
+    }
+    bank.process(x.data(), y.data(), numSamples);
+
+    Scalar scale = 0;
+    Scalar error = 0;
+    for (int i = 0; i < numSamples; ++i) {
+        scale = std::max(scale, std::abs(yReference[i]));
+        error = std::max(error, std::abs(y[i] - yReference[i]));
+    }
+    std::printf(" Cascade against OneFormantFilter, relative max error: %.1e\n",
+                error / scale);
+
+    // The parallel gains should put the peaks at the same level as the cascade.
+    FormantFilterBank parallel = bank;
+    parallel.setTopology(FormantFilterBank::Topology_Parallel);
+    parallel.update();
+    std::printf(" Parallel against cascade at the formant peaks:");
+    for (int k = 0; k < kNumFormants; ++k) {
+        const Scalar dB = 20 * std::log10(std::abs(response(parallel, kF[k])) /
+                                          std::abs(response(bank, kF[k])));
+        std::printf(" %+.2f", dB);
+    }
+    std::printf(" dB\n");
+
+    bench::printTime("coefficients, 5 x OneFormantFilter", bench::timeNs(100'000, [&] {
+                         for (auto& filter : filters) filter.update();
+                         bench::doNotOptimize(filters[0]);
+                     }));
+    bench::printTime("coefficients, bank", bench::timeNs(100'000, [&] {
+                         bank.update();
+                         bench::doNotOptimize(bank);
+                     }));
+
+    bench::printTime("cascade, 5 x OneFormantFilter", bench::timeNs(1'000, [&] {
+                         for (int i = 0; i < numSamples; ++i) {
+                             Scalar yi = x[i];
+                             for (auto& filter : filters) yi = filter.tick(yi);
+                             y[i] = yi;
+                         }
+                         bench::doNotOptimize(y[0]);
+                     }) / numSamples,
+                     "sample");
+    bench::printTime("cascade, bank", bench::timeNs(1'000, [&] {
+                         bank.process(x.data(), y.data(), numSamples);
+                         bench::doNotOptimize(y[0]);
+                     }) / numSamples,
+                     "sample");
+    bench::printTime("parallel, bank", bench::timeNs(1'000, [&] {
+                         parallel.process(x.data(), y.data(), numSamples);
+                         bench::doNotOptimize(y[0]);
+                     }) / numSamples,
+                     "sample");
+}
@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "FormantGenerator.h"
+#include "audio/SampleClock.h"
+
+namespace {
+constexpr int    kBlockSize = 512;
+constexpr int    kBlockCount = 400;
+constexpr Scalar kSampleRate = 48000;
+
+// Renders a few seconds of noise through the formant cascade, optionally with formant
+// changes in the middle. Returns the output and the time spent in ns per sample.
+std::vector<Scalar> render(const int controlPeriod, const bool changes,
+                           double& nsPerSample) {
+    SampleClock         clock(kSampleRate);
+    std::vector<Scalar> input(kBlockSize);
+    FormantGenerator    generator(clock, input);
+
+    generator.setSampleRate(kSampleRate);
+    generator.setNormalized(false);
+    generator.setControlPeriod(controlPeriod);
+
+    std::mt19937                           rng(42);
+    std::uniform_real_distribution<Scalar> noise(-1, 1);
+
+    std::vector<Scalar> block(kBlockSize);
+    std::vector<Scalar> output;
+    output.reserve(kBlockSize * kBlockCount);
+
+    std::chrono::duration<double, std::nano> elapsed(0);
+
+    for (int b = 0; b < kBlockCount; ++b) {
+        if (changes && b == kBlockCount / 4) {
+            generator.frequency(0).setValue(300);
+            generator.frequency(1).setValue(2200);
+        } else if (changes && b == kBlockCount / 2) {
+            generator.frequency(0).setValue(750);
+            generator.bandwidth(1).setValue(200);
+        }
+
+        for (auto& x : input) x = noise(rng);
+
+        const auto start = std::chrono::steady_clock::now();
+        generator.fillBuffer(block);
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        clock.advance(kBlockSize);
+        output.insert(output.end(), block.begin(), block.end());
+    }
+
+    nsPerSample = elapsed.count() / output.size();
+    return output;
+}
+
+// Error of `output` against `reference`, in dB relative to the reference power.
+double errorDb(const std::vector<Scalar>& output, const std::vector<Scalar>& reference) {
+    double power = 0;
+    double errorPower = 0;
+    for (int i = 0; i < int(output.size()); ++i) {
+        power += reference[i] * reference[i];
+        errorPower += (output[i] - reference[i]) * (output[i] - reference[i]);
+    }
+    return 10 * std::log10(errorPower / power);
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("formant-control-rate") {
+    // Without changes only the flutter moves the formants. With changes most of the
+    // error is the transient of the per-sample reference jumping to the new formants,
+    // which the ramps smooth out.
+    double     reference_ns;
+    const auto steady = render(1, false, reference_ns);
+    const auto changing = render(1, true, reference_ns);
+
+    std::printf("  %-16s %10s %10s %14s %14s\n", "control period", "ns/sample", "speedup",
+                "error steady", "error changes");
+    std::printf("  %-16d %10.1f %10.2f %14s %14s\n", 1, reference_ns, 1.0, "-", "-");
+
+    for (const int period : {8, 16, 32, 64}) {
+        double     ns;
+        const auto steadyError = errorDb(render(period, false, ns), steady);
+        const auto changingError = errorDb(render(period, true, ns), changing);
+
+        std::printf("  %-16d %10.1f %10.2f %11.1f dB %11.1f dB\n", period, ns,
+                    reference_ns / ns, steadyError, changingError);
+    }
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "GeneratorSpectrum.h"
+#include "GlottalFlow.h"
+#include "HarmonicSpectrum.h"
+#include "SourceGenerator.h"
+#include "audio/SampleClock.h"
+
+namespace {
+constexpr Scalar kSampleRate = 48000;
+constexpr Scalar kF0 = 110;
+constexpr int    kBlockSize = 800;  // One block per frame at 60 fps.
+
+// Peak of an FFT spectrum around f, as an amplitude in dB.
+Scalar fftPeakDb(const GeneratorSpectrum& spectrum, const Scalar f) {
+    const Scalar binWidth = spectrum.frequencies()[1];
+    const int    center = std::lround(f / binWidth);
+    Scalar       peak = -std::numeric_limits<Scalar>::infinity();
+    for (int i = std::max(center - 2, 0); i <= center + 2; ++i) {
+        peak = std::max(peak, spectrum.magnitudesDb()[i]);
+    }
+    // The spectrum is 10 log10 of the magnitude.
+    return 2 * peak;
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("harmonics") {
+    using clock = std::chrono::steady_clock;
+
+    SampleClock         time(kSampleRate);
+    GlottalFlow         glottalFlow;
+    SourceGenerator     source(time, glottalFlow);
+    GeneratorSpectrum   fft(&source);
+    std::vector<Scalar> block(kBlockSize);
+
+    glottalFlow.setSampleCount(1024);
+    glottalFlow.setModelType(GlottalFlowModel_LF);
+    glottalFlow.parameters().Rd.setValue(1.0);
+
+    // A steady source, so that every frame should give the same levels.
+    source.pitch().setValue(kF0);
+    source.flutterToggle().setValue(false);
+    source.jitterToggle().setValue(false);
+    source.shimmerToggle().setValue(false);
+    source.setSampleRate(kSampleRate);
+    source.setNormalized(false);
+
+    fft.setSampleRate(kSampleRate);
+    fft.setResponseTime(0.00125);
+    fft.setTransformSize(4096);
+
+    // Wait for the first glottal flow table and for the parameter ramps to settle.
+    for (int b = 0; b < 300; ++b) {
+        source.fillBuffer(block);
+        time.advance(kBlockSize);
+        if (std::all_of(block.begin(), block.end(), [](Scalar x) { return x == 0; })) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            b = 0;
+        }
+    }
+
+    std::printf(" %-22s %8s %8s %8s %8s %12s\n", "", "f0", "H1", "H2", "H1-H2",
+                "update");
+
+    for (const int periods : {1, 2, 4}) {
+        HarmonicSpectrum harmonics(&source, &source, periods);
+        harmonics.setSampleRate(kSampleRate);
+
+        std::chrono::duration<double, std::nano> elapsed(0);
+
+        constexpr int blockCount = 60;
+        for (int b = 0; b < blockCount; ++b) {
+            source.fillBuffer(block);
+            time.advance(kBlockSize);
+
+            const auto start = clock::now();
+            harmonics.update();
+            elapsed += clock::now() - start;
+        }
+
+        char label[32];
+        std::snprintf(label, sizeof(label), "Goertzel, %d period%s", periods,
+                      periods > 1 ? "s" : "");
+        std::printf(" %-22s %8.2f %8.2f %8.2f %8.2f %9.1f us\n", label, harmonics.f0(),
+                    harmonics.h1(), harmonics.h2(), harmonics.h1h2(),
+                    elapsed.count() / blockCount / 1000);
+    }
+
+    std::chrono::duration<double, std::nano> elapsed(0);
+
+    // The FFT is smoothed over updates, give it a second.
+    constexpr int blockCount = kSampleRate / kBlockSize;
+    for (int b = 0; b < blockCount; ++b) {
+        source.fillBuffer(block);
+        time.advance(kBlockSize);
+
+        const auto start = clock::now();
+        fft.update();
+        elapsed += clock::now() - start;
+    }
+
+    // The Chebyshev window's gain is the same for both harmonics, only H1-H2 compares.
+    const Scalar h1 = fftPeakDb(fft, kF0);
+    const Scalar h2 = fftPeakDb(fft, 2 * kF0);
+    std::printf(" %-22s %8s %8s %8s %8.2f %9.1f us\n", "FFT 4096, peaks", "", "", "",
+                h1 - h2, elapsed.count() / blockCount / 1000);
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <boost/math/quadrature/gauss_kronrod.hpp>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "Benchmark.h"
+#include "GlottalFlow.h"
+#include "GlottalFlowParameters.h"
+#include "models/LF.h"
+
+using namespace boost::math::quadrature;
+
+namespace {
+// What LF::evaluateAntiderivative used to do for the return phase.
+Scalar quadratureAntiderivative(const models::LF& lf, const Scalar t) {
+    const Scalar Te = lf.Te();
+    if (t <= Te) {
+        return lf.evaluateAntiderivative(t);
+    }
+    const auto& fn = [&lf](Scalar t) -> Scalar { return lf.evaluate(t); };
+    return lf.evaluateAntiderivative(Te) +
+           gauss_kronrod<double, 61>::integrate(fn, Te, t, 15, 1e-12);
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("lf-antiderivative") {
+    constexpr int numSamples = 2048;
+
+    std::vector<Scalar> t(numSamples);
+    std::vector<Scalar> g(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        t[i] = Scalar(i) / numSamples;
+    }
+
+    models::LF            lf;
+    GlottalFlowParameters params;
+    params.setUsingRd(true);
+    lf.updateParameterBounds(params);
+
+    // Regression check of the closed form against adaptive quadrature. They agree to
+    // about ten ulps, anything wrong in the closed form is orders of magnitude above.
+    constexpr Scalar kMaxError = 256 * std::numeric_limits<Scalar>::epsilon();
+
+    std::printf(" Max error against quadrature, relative to max |g|:\n");
+    for (const Scalar Rd : {0.1, 0.3, 0.8, 1.2, 1.8, 2.5, 3.5, 5.0, 6.0}) {
+        params.Rd.setValue(Rd);
+        lf.fitParameters(params);
+        lf.evaluateAntiderivativeBlock(t.data(), g.data(), numSamples);
+
+        Scalar scale = 0;
+        Scalar scalarError = 0;
+        Scalar blockError = 0;
+        for (int i = 0; i < numSamples; ++i) {
+            const Scalar reference = quadratureAntiderivative(lf, t[i]);
+            scale = std::max(scale, std::abs(reference));
+            const Scalar scalar = lf.evaluateAntiderivative(t[i]);
+            scalarError = std::max(scalarError, std::abs(scalar - reference));
+            blockError = std::max(blockError, std::abs(g[i] - reference));
+        }
+        std::printf("  Rd %.1f: scalar %.1e  block %.1e\n", Rd, scalarError / scale,
+                    blockError / scale);
+        bench::check(scalarError / scale < kMaxError, "scalar closed form accuracy");
+        bench::check(blockError / scale < kMaxError, "block closed form accuracy");
+    }
+
+    params.Rd.setValue(1.2);
+    lf.fitParameters(params);
+
+    int i = 0;
+    bench::printTime("quadrature, return phase", bench::timeNs(20'000, [&] {
+                         const Scalar ti = 0.9 + 0.1 * Scalar(i++ % 1024) / 1024;
+                         bench::doNotOptimize(quadratureAntiderivative(lf, ti));
+                     }));
+    bench::printTime("closed form, return phase", bench::timeNs(1'000'000, [&] {
+                         const Scalar ti = 0.9 + 0.1 * Scalar(i++ % 1024) / 1024;
+                         bench::doNotOptimize(lf.evaluateAntiderivative(ti));
+                     }));
+    bench::printTime("closed form, block", bench::timeNs(1'000, [&] {
+                         lf.evaluateAntiderivativeBlock(t.data(), g.data(), numSamples);
+                         bench::doNotOptimize(g[0]);
+                     }) / numSamples,
+                     "sample");
+
+    GlottalFlow glottalFlow;
+    glottalFlow.setModelType(GlottalFlowModel_LF);
+    glottalFlow.setSampleCount(numSamples);
+    bench::printTime("GlottalFlow::updateSamples", bench::timeNs(1'000, [&] {
+                         glottalFlow.updateSamples();
+                     }) / numSamples,
+                     "sample");
+}
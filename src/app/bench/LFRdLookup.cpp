@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+
+#include "Benchmark.h"
+#include "GlottalFlowParameters.h"
+#include "models/LF.h"
+
+using namespace models::precomp;
+
+namespace {
+constexpr std::array<const char*, 5> parameterNames = {"Te", "Tp", "Ta", "alpha",
+                                                       "1/epsilon"};
+
+std::array<Scalar, 5> tableRow(const int j) {
+    const auto [Te, Tp, Ta, alpha, epsilon] = Rd_table[j];
+    return {Te, Tp, Ta, alpha, 1 / epsilon};
+}
+
+// What LF::fitParameters did before interpolation: snap to the row below.
+std::array<Scalar, 5> floorLookup(const Scalar Rd, const int stride) {
+    const int index = std::floor((Rd - Rd_min) / (stride * Rd_step));
+    return tableRow(index * stride);
+}
+
+std::array<Scalar, 5> cubicLookup(const Scalar Rd, const int stride) {
+    const auto [Te, Tp, Ta, alpha, epsilon] = models::LF::interpolateRd(Rd, stride);
+    return {Te, Tp, Ta, alpha, 1 / epsilon};
+}
+
+// The Rd regression is piecewise, parameters have kinks or small jumps at those Rd.
+constexpr std::array<Scalar, 3> breakpoints = {0.21, 1.8476, 2.7};
+
+bool isNearBreakpoint(const Scalar Rd, const int stride) {
+    return std::any_of(breakpoints.begin(), breakpoints.end(), [=](const Scalar x) {
+        return std::abs(Rd - x) < 2 * stride * Rd_step;
+    });
+}
+
+// Worst error over the rows that a table with the given stride skips, relative to the
+// largest magnitude of each parameter. The rows come from the precompute tool, so this
+// is the error against its octuple-precision results at those Rd values.
+template <typename Lookup>
+void printError(const char* label, const int stride, const bool skipBreakpoints,
+                Lookup&& lookup) {
+    std::array<Scalar, 5> scale{};
+    for (int j = 0; j < int(Rd_table.size()); ++j) {
+        const auto row = tableRow(j);
+        for (int k = 0; k < 5; ++k) {
+            scale[k] = std::max(scale[k], std::abs(row[k]));
+        }
+    }
+
+    const int             last = (int(Rd_table.size()) - 1) / stride * stride;
+    std::array<Scalar, 5> error{};
+    for (int j = 0; j < last; ++j) {
+        const Scalar Rd = Rd_min + j * Rd_step;
+        if (j % stride == 0 || (skipBreakpoints && isNearBreakpoint(Rd, stride))) {
+            continue;
+        }
+        const auto row = tableRow(j);
+        const auto estimate = lookup(Rd, stride);
+        for (int k = 0; k < 5; ++k) {
+            error[k] = std::max(error[k], std::abs(estimate[k] - row[k]) / scale[k]);
+        }
+    }
+
+    std::printf("  %-10s step %.3f:", label, stride * Rd_step);
+    for (int k = 0; k < 5; ++k) {
+        std::printf("  %s %.1e", parameterNames[k], error[k]);
+    }
+    std::printf("\n");
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("lf-rd-lookup") {
+    std::printf(" Max error between table rows, relative to each parameter's range:\n");
+    for (const int stride : {2, 4, 8, 16}) {
+        printError("floor", stride, false, floorLookup);
+        printError("cubic", stride, false, cubicLookup);
+        printError("cubic*", stride, true, cubicLookup);
+    }
+    std::printf(" (*) away from the breakpoints of the Rd regression\n");
+
+    // Exponential Rd ramp, as when the parameter is smoothed.
+    constexpr int numSteps = 4096;
+
+    std::array<Scalar, numSteps> ramp;
+    for (int i = 0; i < numSteps; ++i) {
+        ramp[i] = Rd_min * std::pow(Scalar(Rd_max / Rd_min), Scalar(i) / numSteps);
+    }
+
+    int i = 0;
+    bench::printTime("floor lookup", bench::timeNs(1'000'000, [&] {
+                         bench::doNotOptimize(floorLookup(ramp[i++ % numSteps], 1));
+                     }));
+    bench::printTime("cubic lookup", bench::timeNs(1'000'000, [&] {
+                         bench::doNotOptimize(cubicLookup(ramp[i++ % numSteps], 1));
+                     }));
+
+    models::LF            lf;
+    GlottalFlowParameters params;
+    params.setUsingRd(true);
+    lf.updateParameterBounds(params);
+    bench::printTime("LF::fitParameters (Rd)", bench::timeNs(100'000, [&] {
+                         params.Rd.setValue(ramp[i++ % numSteps]);
+                         lf.fitParameters(params);
+                     }));
+}
@@ -45,7 +45,7 @@ Scalar OneFormantFilter::qualityMultiplier() const { return m_qMult; }
 
 void OneFormantFilter::setQualityMultiplier(const Scalar qMult) { m_qMult = qMult; }
 
-void OneFormantFilter::update() {
+void OneFormantFilter::update(const int rampLength) {
     const Scalar r = std::exp(-pi<Scalar>() * m_bw / m_fs);
 
     const Scalar cosTheta = cos_pi(2 * m_fc / m_fs);
@@ -61,12 +61,20 @@ void OneFormantFilter::update() {
     // Gain at DC is when z = +1.
     const Scalar gDC = (b0 + b1 + b2) / (1 + a1 + a2);
 
-    m_biquad.update(b0 / gDC, b1 / gDC, b2 / gDC, a1, a2);
+    if (rampLength > 0) {
+        m_biquad.rampTo(b0 / gDC, b1 / gDC, b2 / gDC, a1, a2, rampLength);
+    } else {
+        m_biquad.update(b0 / gDC, b1 / gDC, b2 / gDC, a1, a2);
+    }
     m_coefs = {b0 / gDC, b1 / gDC, b2 / gDC, 1.0_f, a1, a2};
 }
 
 Scalar OneFormantFilter::tick(const Scalar x) { return m_biquad.tick(x); }
 
+void OneFormantFilter::process(const Scalar* in, Scalar* out, const int n) {
+    m_biquad.process(in, out, n);
+}
+
 const std::array<Scalar, 6>& OneFormantFilter::getBiquadCoefficients() const {
     return m_coefs;
 }
\ No newline at end of file
@@ -27,8 +27,11 @@ class OneFormantFilter {
     Scalar qualityMultiplier() const;
     void   setQualityMultiplier(Scalar qMult);
 
-    void   update();
+    // Recomputes the coefficients. With rampLength > 0 the filter glides to them over
+    // that many ticks instead of switching at once.
+    void   update(int rampLength = 0);
     Scalar tick(Scalar x);
+    void   process(const Scalar* in, Scalar* out, int n);
 
     const std::array<Scalar, 6>& getBiquadCoefficients() const;
 
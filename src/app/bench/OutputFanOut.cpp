@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "audio/AudioBlock.h"
+
+namespace {
+constexpr int kFrames = 1024;
+
+// What the callbacks used to do after the generators: volume in the app, then a
+// division by the channel count, a conversion to float and a copy to every other
+// channel in the output. The generator rendered into buffer, here the volume pass
+// reads from the signal instead, which only flatters the legacy timing.
+void legacyOutput(const std::vector<Scalar>& signal, const Scalar volume,
+                  std::vector<Scalar>& buffer, float* const output, const int channels) {
+    for (int i = 0; i < kFrames; ++i) buffer[i] = signal[i] * volume;
+    for (auto& x : buffer) x /= channels;
+    std::transform(buffer.begin(), buffer.end(), output,
+                   [](const Scalar x) { return (float)x; });
+    for (int c = 1; c < channels; ++c) {
+        std::copy(output, output + kFrames, &output[c * kFrames]);
+    }
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("output-fan-out") {
+    std::mt19937                           rng(42);
+    std::uniform_real_distribution<Scalar> noise(-1, 1);
+
+    std::vector<Scalar> source(kFrames);
+    std::vector<Scalar> filtered(kFrames);
+    for (auto& x : source) x = noise(rng);
+    for (auto& x : filtered) x = noise(rng);
+
+    constexpr Scalar volume = 0.6561;
+
+    AudioBlock block{};
+    block.length = kFrames;
+    block.main = &filtered;
+    block.mainGain = volume;
+    block.aux = &source;
+    block.auxGain = 0.25_f * volume;
+
+    std::printf(" Blocks of %d frames:\n", kFrames);
+    for (const int channels : {1, 2, 8}) {
+        std::vector<float>  output(channels * kFrames);
+        std::vector<Scalar> buffer(kFrames);
+
+        // Same samples as before, up to the rounding of the gains.
+        legacyOutput(filtered, volume, buffer, output.data(), channels);
+        const std::vector<float> expected = output;
+        writeAudioBlock(block, AudioRouting_Mono, 1, 0, output.data(), channels, kFrames);
+        float error = 0;
+        for (int i = 0; i < channels * kFrames; ++i) {
+            error = std::max(error, std::abs(output[i] - expected[i]));
+        }
+
+        char label[48];
+        std::snprintf(label, sizeof(label), "%d ch, legacy", channels);
+        bench::printTime(label, bench::timeNs(10'000, [&] {
+                             legacyOutput(filtered, volume, buffer, output.data(),
+                                          channels);
+                             bench::doNotOptimize(output[0]);
+                         }));
+        std::snprintf(label, sizeof(label), "%d ch, fused", channels);
+        bench::printTime(label, bench::timeNs(10'000, [&] {
+                             writeAudioBlock(block, AudioRouting_Mono, 1, 0,
+                                             output.data(), channels, kFrames);
+                             bench::doNotOptimize(output[0]);
+                         }));
+        std::printf("   max difference %.1e\n", error);
+    }
+
+    std::vector<float> output(2 * kFrames);
+    bench::printTime("2 ch, split", bench::timeNs(10'000, [&] {
+                         writeAudioBlock(block, AudioRouting_Split, 1, 0, output.data(),
+                                         2, kFrames);
+                         bench::doNotOptimize(output[0]);
+                     }));
+}
@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.h"
+#include "FormantGenerator.h"
+#include "GlottalFlow.h"
+#include "SourceGenerator.h"
+#include "audio/RealtimeAudit.h"
+#include "audio/SampleClock.h"
+
+namespace {
+constexpr Scalar kSampleRate = 48000;
+constexpr int    kBlockSize = 512;
+constexpr int    kBlockCount = 2000;
+
+// The app's callback chain, source into formants, with every block audited. With
+// isSwitching, the oversampling factor cycles through 1x to 8x while it runs, like
+// picking it in the Audio menu.
+void runChain(const bool prepare, const int oversampling,
+              const bool isSwitching = false) {
+    using clock = std::chrono::steady_clock;
+
+    SampleClock         time(kSampleRate);
+    GlottalFlow         glottalFlow;
+    SourceGenerator     source(time, glottalFlow);
+    std::vector<Scalar> intermediate(kBlockSize);
+    FormantGenerator    formants(time, intermediate);
+    std::vector<Scalar> block(kBlockSize);
+
+    glottalFlow.parameters().Rd.valueChanged.connect(&SourceGenerator::handleParamChanged,
+                                                     &source);
+    glottalFlow.setSampleCount(1024);
+    glottalFlow.setModelType(GlottalFlowModel_LF);
+    glottalFlow.parameters().setUsingRd(true);
+    glottalFlow.parameters().Rd.setValue(1.0);
+
+    source.pitch().setValue(110);
+    source.setOversampling(oversampling);
+    source.setSampleRate(kSampleRate);
+    source.setNormalized(true);
+    formants.setSampleRate(kSampleRate);
+    formants.setNormalized(false);
+
+    if (prepare) {
+        source.prepare(kBlockSize);
+        formants.prepare(kBlockSize);
+    }
+
+    RealtimeAudit::resetCounts();
+
+    const auto start = clock::now();
+    for (int b = 0; b < kBlockCount; ++b) {
+        if (isSwitching && b % 100 == 0) {
+            source.setOversampling(1 << (b / 100 % 4));
+        }
+
+        RealtimeAudit::Scope realtime;
+        source.fillBuffer(intermediate);
+        formants.fillBuffer(block);
+        time.advance(kBlockSize);
+        bench::doNotOptimize(block);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+
+    const auto counts = RealtimeAudit::counts();
+
+    char label[48];
+    if (isSwitching) {
+        std::snprintf(label, sizeof(label), "%s, switching 1x-8x",
+                      prepare ? "prepared" : "unprepared");
+    } else {
+        std::snprintf(label, sizeof(label), "%s, %dx",
+                      prepare ? "prepared" : "unprepared", oversampling);
+    }
+    bench::printTime(label, elapsed.count() / kBlockCount, "block");
+    std::printf("   %llu allocations, %llu deallocations, %llu locks\n",
+                (unsigned long long)counts.allocations,
+                (unsigned long long)counts.deallocations,
+                (unsigned long long)counts.locks);
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("rt-audit") {
+    if (!RealtimeAudit::kEnabled) {
+        std::printf("   Configure with -DSOURCEMODEL_RT_AUDIT=ON to count violations.\n");
+    }
+
+    for (const int oversampling : {1, 4}) {
+        runChain(false, oversampling);
+        runChain(true, oversampling);
+    }
+    runChain(true, 1, true);
+}
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "audio/RealtimeAudit.h"
+#include "math/filters/Butterworth.h"
+
+#ifndef SOURCEMODEL_RT_AUDIT
+// Counts every heap allocation made by the benchmark executable. With the real-time
+// audit, which replaces these operators on some platforms, its counts are used.
+namespace {
+std::atomic<long> allocationCount(0);
+}  // namespace
+
+void* operator new(const std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+namespace {
+constexpr Scalar kSampleRate = 48000;
+constexpr int    kBlockSize = 512;
+constexpr int    kBlockCount = 1000;
+
+// Heap allocations per call of fn.
+template <typename Fn>
+double allocationsPerCall(const int calls, Fn&& fn) {
+#ifdef SOURCEMODEL_RT_AUDIT
+    RealtimeAudit::resetCounts();
+    {
+        RealtimeAudit::Scope realtime;
+        for (int i = 0; i < calls; ++i) {
+            fn();
+        }
+    }
+    return double(RealtimeAudit::counts().allocations) / calls;
+#else
+    const long before = allocationCount.load();
+    for (int i = 0; i < calls; ++i) {
+        fn();
+    }
+    return double(allocationCount.load() - before) / calls;
+#endif
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("sos-filter") {
+    std::mt19937                           rng(42);
+    std::uniform_real_distribution<Scalar> noise(-1, 1);
+
+    std::vector<Scalar> block(kBlockSize);
+    for (auto& x : block) x = noise(rng);
+
+    // Same filter as the source antialiasing filter.
+    Butterworth filter;
+    filter.loPass(kSampleRate, kSampleRate / 2 - 1000, 1);
+
+    std::printf(" Allocations per %d-sample block:\n", kBlockSize);
+    std::printf("  filter   %.2f\n", allocationsPerCall(kBlockCount, [&] {
+                    block = filter.filter(block);
+                }));
+    std::printf("  process  %.2f\n", allocationsPerCall(kBlockCount, [&] {
+                    filter.process(block.data(), kBlockSize);
+                }));
+
+    // The sections of each order should multiply to unit gain at DC.
+    std::printf(" Butterworth lowpass gain at DC:");
+    for (int order = 1; order <= 6; ++order) {
+        Butterworth lowpass;
+        lowpass.loPass(kSampleRate, 4000, order);
+        // Butterworth::coefficients hides the SOSFilter one.
+        const SOSFilter& sos = lowpass;
+        Scalar           gain = 1;
+        for (const auto& s : sos.coefficients()) {
+            gain *= (s[0] + s[1] + s[2]) / (s[3] + s[4] + s[5]);
+        }
+        std::printf(" %.4f", gain);
+    }
+    std::printf("\n");
+
+    Butterworth lowpass;
+    lowpass.loPass(kSampleRate, 4000, 4);
+
+    bench::printTime("order 4, filter", bench::timeNs(1'000, [&] {
+                         block = lowpass.filter(block);
+                         bench::doNotOptimize(block[0]);
+                     }) / kBlockSize,
+                     "sample");
+    bench::printTime("order 4, process", bench::timeNs(1'000, [&] {
+                         lowpass.process(block.data(), kBlockSize);
+                         bench::doNotOptimize(block[0]);
+                     }) / kBlockSize,
+                     "sample");
+
+    // Eight signals through the same sections, one after the other or interleaved.
+    constexpr int       kChannels = 8;
+    std::vector<Scalar> channels(kChannels * kBlockSize);
+    for (auto& x : channels) x = noise(rng);
+
+    bench::printTime("order 4, 8 channels one by one", bench::timeNs(1'000, [&] {
+                         for (int c = 0; c < kChannels; ++c) {
+                             lowpass.process(&channels[c * kBlockSize], kBlockSize);
+                         }
+                         bench::doNotOptimize(channels[0]);
+                     }) / (kChannels * kBlockSize),
+                     "sample");
+
+    lowpass.setChannelCount(kChannels);
+    bench::printTime("order 4, 8 channels interleaved", bench::timeNs(1'000, [&] {
+                         lowpass.process(channels.data(), kChannels * kBlockSize);
+                         bench::doNotOptimize(channels[0]);
+                     }) / (kChannels * kBlockSize),
+                     "sample");
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "OneFormantFilter.h"
+#include "math/filters/SVFBiquad.h"
+
+namespace {
+// What SVFBiquad used to do: three full SVFs with their own state, each returning one
+// of its outputs, for the same g and R.
+class LegacySVFPiece {
+   public:
+    enum FltType { FltType_HIGHPASS, FltType_BANDPASS, FltType_LOWPASS };
+
+    void update(const Scalar g, const Scalar R, const FltType type) {
+        _type = type;
+        _g = g;
+        _R = R;
+    }
+
+    Scalar tick(const Scalar x) {
+        const Scalar HP =
+            (x - (2.0_f * _R + _g) * _z1 - _z2) / (1.0_f + (2.0_f * _R * _g) + _g * _g);
+        const Scalar BP = HP * _g + _z1;
+        const Scalar LP = BP * _g + _z2;
+
+        _z1 = _g * HP + BP;
+        _z2 = _g * BP + LP;
+
+        switch (_type) {
+            case FltType_HIGHPASS:
+                return HP;
+            case FltType_BANDPASS:
+                return BP;
+            case FltType_LOWPASS:
+            default:
+                return LP;
+        }
+    }
+
+   private:
+    FltType _type = FltType_LOWPASS;
+    Scalar  _g = 0;
+    Scalar  _R = 0;
+    Scalar  _z1 = 0;
+    Scalar  _z2 = 0;
+};
+
+class LegacySVFBiquad {
+   public:
+    // Takes the SVF coefficients directly, the design is the same as SVFBiquad::update.
+    void update(const Scalar g, const Scalar R, const Scalar cHP, const Scalar cBP,
+                const Scalar cLP) {
+        _cHP = cHP;
+        _cBP = cBP;
+        _cLP = cLP;
+        _HP.update(g, R, LegacySVFPiece::FltType_HIGHPASS);
+        _BP.update(g, R, LegacySVFPiece::FltType_BANDPASS);
+        _LP.update(g, R, LegacySVFPiece::FltType_LOWPASS);
+    }
+
+    Scalar tick(const Scalar x) {
+        return _cHP * _HP.tick(x) + _cBP * _BP.tick(x) + _cLP * _LP.tick(x);
+    }
+
+   private:
+    Scalar         _cHP = 0;
+    Scalar         _cBP = 0;
+    Scalar         _cLP = 0;
+    LegacySVFPiece _HP;
+    LegacySVFPiece _BP;
+    LegacySVFPiece _LP;
+};
+
+// The normalized resonator of OneFormantFilter, as SVF coefficients.
+void resonator(const Scalar fc, const Scalar bw, const Scalar fs, SVFBiquad& fused,
+               LegacySVFBiquad& legacy) {
+    const Scalar r = std::exp(-Scalar(M_PI) * bw / fs);
+    const Scalar a1 = -2 * r * std::cos(2 * Scalar(M_PI) * fc / fs);
+    const Scalar a2 = r * r;
+    const Scalar b0 = 1 + a1 + a2;
+
+    fused.update(b0, 0, 0, a1, a2);
+
+    const Scalar asm1 = std::sqrt(1 + a1 + a2);
+    const Scalar asm2 = std::sqrt(1 - a1 + a2);
+    const Scalar sm1mul2 = -asm1 * asm2;
+    legacy.update(asm1 / asm2, (a2 - 1) / sm1mul2, b0 / (1 - a1 + a2), 2 * b0 / sm1mul2,
+                  b0 / (1 + a1 + a2));
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("svf-biquad") {
+    constexpr int    numSamples = 4096;
+    constexpr Scalar fs = 48000;
+
+    std::mt19937                           rng(42);
+    std::uniform_real_distribution<Scalar> noise(-1, 1);
+
+    std::vector<Scalar> x(numSamples);
+    for (auto& xi : x) xi = noise(rng);
+
+    std::vector<Scalar> y(numSamples);
+    std::vector<Scalar> yLegacy(numSamples);
+
+    // The fused kernel computes the same filter, up to rounding.
+    std::printf(" Max difference to the three-SVF kernel, relative to max |y|:\n");
+    for (const auto& [fc, bw] : {std::pair<Scalar, Scalar>{300, 60}, {1500, 90},
+                                 {3500, 150}, {12000, 400}}) {
+        SVFBiquad       fused;
+        LegacySVFBiquad legacy;
+        resonator(fc, bw, fs, fused, legacy);
+
+        fused.process(x.data(), y.data(), numSamples);
+        for (int i = 0; i < numSamples; ++i) {
+            yLegacy[i] = legacy.tick(x[i]);
+        }
+
+        Scalar scale = 0;
+        Scalar error = 0;
+        for (int i = 0; i < numSamples; ++i) {
+            scale = std::max(scale, std::abs(yLegacy[i]));
+            error = std::max(error, std::abs(y[i] - yLegacy[i]));
+        }
+        std::printf("  F %5.0f Hz, B %3.0f Hz: %.1e\n", fc, bw, error / scale);
+    }
+
+    SVFBiquad       fused;
+    LegacySVFBiquad legacy;
+    resonator(700, 80, fs, fused, legacy);
+
+    bench::printTime("three SVFs, tick", bench::timeNs(1'000, [&] {
+                         for (int i = 0; i < numSamples; ++i) {
+                             yLegacy[i] = legacy.tick(x[i]);
+                         }
+                         bench::doNotOptimize(yLegacy[0]);
+                     }) / numSamples,
+                     "sample");
+    bench::printTime("fused, tick", bench::timeNs(1'000, [&] {
+                         for (int i = 0; i < numSamples; ++i) {
+                             y[i] = fused.tick(x[i]);
+                         }
+                         bench::doNotOptimize(y[0]);
+                     }) / numSamples,
+                     "sample");
+    bench::printTime("fused, process", bench::timeNs(1'000, [&] {
+                         fused.process(x.data(), y.data(), numSamples);
+                         bench::doNotOptimize(y[0]);
+                     }) / numSamples,
+                     "sample");
+
+    // Five formants in cascade. FormantGenerator runs them sample by sample: each SVF
+    // is one long dependency chain, and interleaving the five lets them overlap, while
+    // processing a whole block per formant runs the chains one after the other.
+    std::vector<OneFormantFilter> cascade;
+    for (const auto& [fc, bw] : {std::pair<Scalar, Scalar>{700, 80}, {1200, 90},
+                                 {2600, 120}, {3500, 150}, {4500, 200}}) {
+        cascade.emplace_back(fc, bw, fs);
+        cascade.back().update();
+    }
+    bench::printTime("5 formants, tick", bench::timeNs(1'000, [&] {
+                         for (int i = 0; i < numSamples; ++i) {
+                             Scalar yi = x[i];
+                             for (auto& filter : cascade) yi = filter.tick(yi);
+                             y[i] = yi;
+                         }
+                         bench::doNotOptimize(y[0]);
+                     }) / numSamples,
+                     "sample");
+    bench::printTime("5 formants, process", bench::timeNs(1'000, [&] {
+                         cascade[0].process(x.data(), y.data(), numSamples);
+                         for (int k = 1; k < int(cascade.size()); ++k) {
+                             cascade[k].process(y.data(), y.data(), numSamples);
+                         }
+                         bench::doNotOptimize(y[0]);
+                     }) / numSamples,
+                     "sample");
+}
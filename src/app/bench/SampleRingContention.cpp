@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <atomic>
+#include <boost/circular_buffer.hpp>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "audio/SampleRing.h"
+
+namespace {
+constexpr int kBlockSize = 256;
+constexpr int kBlockCount = 5000;
+constexpr int kReadLength = 32768;  // The largest transform size.
+
+// What BufferedGenerator did before: a circular buffer behind a shared_mutex.
+class LockedRing {
+   public:
+    LockedRing(const int capacity) : m_buffer(capacity, 0) {}
+
+    void write(const Scalar* samples, const int count, uint64_t) {
+        std::unique_lock lock(m_mutex);
+        m_buffer.insert(m_buffer.end(), samples, samples + count);
+    }
+
+    uint64_t read(Scalar* out, const int count) {
+        std::shared_lock lock(m_mutex);
+        std::copy(std::prev(m_buffer.end(), count), m_buffer.end(), out);
+        return 0;
+    }
+
+   private:
+    std::shared_mutex              m_mutex;
+    boost::circular_buffer<Scalar> m_buffer;
+};
+
+// Times every write of an audio-like thread while another thread keeps copying the
+// whole buffer, like a UI drawing very large transforms as fast as it can.
+template <typename Ring>
+void measure(const char* label, Ring& ring) {
+    using clock = std::chrono::steady_clock;
+
+    std::atomic_bool    stop(false);
+    std::atomic_int64_t readCount(0);
+
+    std::thread reader([&] {
+        std::vector<Scalar> out(kReadLength);
+        while (!stop) {
+            ring.read(out.data(), kReadLength);
+            bench::doNotOptimize(out.data());
+            readCount++;
+        }
+    });
+
+    std::vector<Scalar> block(kBlockSize, 0.5);
+    std::vector<double> writeNs(kBlockCount);
+
+    for (int b = 0; b < kBlockCount; ++b) {
+        const auto start = clock::now();
+        ring.write(block.data(), kBlockSize, uint64_t(b) * kBlockSize);
+        const auto end = clock::now();
+        writeNs[b] = std::chrono::duration<double, std::nano>(end - start).count();
+
+        // A callback every 0.5 ms, ten times as often as 256 samples at 48 kHz.
+        const auto next = start + std::chrono::microseconds(500);
+        while (clock::now() < next) {
+        }
+    }
+
+    stop = true;
+    reader.join();
+
+    std::sort(writeNs.begin(), writeNs.end());
+    std::printf("  %-16s median %8.0f ns, 99.9%% %8.0f ns, max %9.0f ns, %lld reads\n",
+                label, writeNs[kBlockCount / 2], writeNs[kBlockCount * 999 / 1000],
+                writeNs.back(), (long long)readCount);
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("sample-ring") {
+    std::printf(" Writes of %d samples with a reader copying %d samples:\n", kBlockSize,
+                kReadLength);
+
+    LockedRing locked(kReadLength);
+    measure("shared_mutex", locked);
+
+    SampleRing ring(kReadLength);
+    measure("SampleRing", ring);
+}
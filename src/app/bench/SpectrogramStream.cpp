@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Spectrogram.h"
+
+namespace {
+constexpr Scalar kSampleRate = 48000;
+constexpr int    kBlockSize = 512;
+
+// Rows of the image that hold an analyzed frame.
+int analyzedFrames(const std::vector<Scalar>& image, const int binCount) {
+    int count = 0;
+    for (int row = 0; row * binCount < image.size(); ++row) {
+        count += std::isfinite(image[row * binCount]);
+    }
+    return count;
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("spectrogram") {
+    using clock = std::chrono::steady_clock;
+
+    constexpr int    nfft = 1024;
+    constexpr int    hop = 256;
+    constexpr int    frameCount = 256;
+    constexpr Scalar f0 = 1500;  // Exactly on bin 32.
+
+    // A second of a sine, all of it fits in the queue.
+    std::vector<Scalar> signal(static_cast<int>(kSampleRate));
+    for (int i = 0; i < signal.size(); ++i) {
+        signal[i] = std::sin(2 * Scalar(M_PI) * f0 * i / kSampleRate);
+    }
+    const int written = int(signal.size()) / kBlockSize * kBlockSize;
+    const int expectedFrames = (written - nfft) / hop + 1;
+
+    Spectrogram spectrogram(nfft, hop, frameCount);
+    spectrogram.setSampleRate(kSampleRate);
+
+    const auto start = clock::now();
+    for (int i = 0; i < written; i += kBlockSize) {
+        spectrogram.write(&signal[i], kBlockSize);
+    }
+
+    // Wait for the worker to go through every frame.
+    std::vector<Scalar> image;
+    const int           binCount = spectrogram.binCount();
+    int                 frames = 0;
+    while (clock::now() - start < std::chrono::seconds(5)) {
+        spectrogram.update();
+        spectrogram.copyTo(image, binCount);
+        frames = analyzedFrames(image, binCount);
+        if (frames >= expectedFrames) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+
+    int peak = 0;
+    for (int k = 1; k < binCount; ++k) {
+        if (image[k] > image[peak]) peak = k;
+    }
+    std::printf(" %d of %d frames analyzed, peak at %.1f Hz (%.1f dB), %llu dropped\n",
+                frames, expectedFrames, peak * kSampleRate / nfft, image[peak],
+                (unsigned long long)spectrogram.droppedSamples());
+
+    bench::printTime("1 s of audio, 75% overlap", elapsed.count() / frames, "frame");
+
+    // Cost on the audio thread, the worker analyzes concurrently.
+    bench::printTime("write, 512 samples", bench::timeNs(1'000, [&] {
+                         spectrogram.write(signal.data(), kBlockSize);
+                     }));
+}
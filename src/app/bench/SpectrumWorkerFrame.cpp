@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "GeneratorSpectrum.h"
+#include "SpectrumWorker.h"
+#include "audio/BufferedGenerator.h"
+#include "audio/SampleClock.h"
+
+namespace {
+constexpr Scalar kSampleRate = 48000;
+constexpr int    kBlockSize = 800;  // One block per frame at 60 fps.
+constexpr int    kFrameCount = 120;
+
+class NoiseGenerator : public BufferedGenerator {
+   public:
+    using BufferedGenerator::BufferedGenerator;
+
+   protected:
+    void fillInternalBuffer(std::vector<Scalar>& out) override {
+        for (auto& x : out) x = m_distribution(m_rng);
+    }
+
+   private:
+    std::mt19937                           m_rng{1234};
+    std::uniform_real_distribution<Scalar> m_distribution{-1, 1};
+};
+
+// Time the UI thread spends per frame on the spectrum, with or without the worker.
+double uiTimePerFrame(const int nfft, SpectrumWorker* worker) {
+    using clock = std::chrono::steady_clock;
+
+    SampleClock         time(kSampleRate);
+    NoiseGenerator      generator(time);
+    GeneratorSpectrum   spectrum(&generator);
+    std::vector<Scalar> block(kBlockSize);
+
+    generator.setSampleRate(kSampleRate);
+    generator.setNormalized(false);
+    spectrum.setSampleRate(kSampleRate);
+    spectrum.setResponseTime(0.00125);
+    spectrum.setTransformSize(nfft);
+    spectrum.setWorker(worker);
+
+    std::chrono::duration<double, std::nano> elapsed(0);
+
+    for (int frame = 0; frame < kFrameCount; ++frame) {
+        generator.fillBuffer(block);
+        time.advance(kBlockSize);
+
+        const auto start = clock::now();
+        if (worker != nullptr) {
+            worker->requestUpdate();
+        }
+        spectrum.update();
+        bench::doNotOptimize(spectrum.magnitudesDb());
+        elapsed += clock::now() - start;
+
+        // The rest of the frame, during which the worker catches up.
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    return elapsed.count() / kFrameCount;
+}
+}  // namespace
+
+SOURCEMODEL_BENCHMARK("spectrum-worker") {
+    SpectrumWorker worker;
+
+    for (int nfft = 4096; nfft <= 32768; nfft *= 2) {
+        char label[48];
+        std::snprintf(label, sizeof(label), "nfft %d, UI thread", nfft);
+        bench::printTime(label, uiTimePerFrame(nfft, nullptr), "frame");
+        std::snprintf(label, sizeof(label), "nfft %d, worker", nfft);
+        bench::printTime(label, uiTimePerFrame(nfft, &worker), "frame");
+    }
+}
@@ -0,0 +1,73 @@
+#include <argparse.hpp>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+
+std::vector<bench::Benchmark>& bench::registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+void bench::printTime(const char* label, const double ns, const char* unit) {
+    std::printf("  %-40s %10.1f ns/%s\n", label, ns, unit);
+}
+
+namespace {
+int failures = 0;
+}  // namespace
+
+bool bench::check(const bool condition, const char* what) {
+    if (!condition) {
+        std::printf("  FAILED: %s\n", what);
+        ++failures;
+    }
+    return condition;
+}
+
+int bench::failureCount() { return failures; }
+
+int main(int argc, char** argv) {
+    argparse::ArgumentParser program("SourceModelBench");
+
+    program.add_description("Runs the engine micro-benchmarks.");
+
+    program.add_argument("filter")
+        .help("only run the benchmarks whose name contains this")
+        .default_value(std::string());
+
+    program.add_argument("--list")
+        .help("list the benchmarks and exit")
+        .default_value(false)
+        .implicit_value(true);
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::runtime_error& err) {
+        std::cerr << err.what() << "\n\n" << program;
+        return 1;
+    }
+
+    const auto filter = program.get<std::string>("filter");
+
+    for (const auto& benchmark : bench::registry()) {
+        if (benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        if (program.get<bool>("--list")) {
+            std::printf("%s\n", benchmark.name.c_str());
+        } else {
+            std::printf("%s\n", benchmark.name.c_str());
+            benchmark.run();
+            std::printf("\n");
+        }
+    }
+
+    if (bench::failureCount() > 0) {
+        std::printf("%d check(s) failed\n", bench::failureCount());
+        return 1;
+    }
+    return 0;
+}
@@ -1,12 +1,75 @@
+#include <cstdio>
 #include <cstdlib>
+#include <filesystem>
+#include <system_error>
 
 #include "SourceModelApp.h"
+#include "audio/RealtimeAudit.h"
+#include "math/FFTPlanCache.h"
+
+#ifndef __EMSCRIPTEN__
+// Per-user cache file for the FFTW wisdom, empty if there is nowhere to put it.
+static std::filesystem::path wisdomPath() {
+    std::filesystem::path dir;
+    #if defined(_WIN32)
+    if (const char* localAppData = std::getenv("LOCALAPPDATA")) {
+        dir = std::filesystem::path(localAppData) / "SourceModel";
+    }
+    #elif defined(__APPLE__)
+    if (const char* home = std::getenv("HOME")) {
+        dir = std::filesystem::path(home) / "Library" / "Caches" / "SourceModel";
+    }
+    #else
+    if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache && *cache) {
+        dir = std::filesystem::path(cache) / "SourceModel";
+    } else if (const char* home = std::getenv("HOME")) {
+        dir = std::filesystem::path(home) / ".cache" / "SourceModel";
+    }
+    #endif
+
+    std::error_code error;
+    if (dir.empty() || (!std::filesystem::create_directories(dir, error) && error)) {
+        return {};
+    }
+    // Wisdom is only valid for one precision.
+    return dir / (sizeof(Scalar) == sizeof(double) ? "fftw-double.wisdom"
+                                                    : "fftw-float.wisdom");
+}
+#endif
 
 int main(int argc, char** argv) {
+#ifndef __EMSCRIPTEN__
+    // Measured plans are only slow to make the first time, after that they come from
+    // the wisdom saved by the previous run.
+    const auto wisdom = wisdomPath();
+    if (!wisdom.empty()) {
+        FFTPlanCache<Scalar>::instance().importWisdom(wisdom.string());
+    }
+#endif
+
+    if (RealtimeAudit::kEnabled) {
+        const bool abort = std::getenv("SOURCEMODEL_RT_AUDIT_ABORT") != nullptr;
+        RealtimeAudit::setAbortOnViolation(abort);
+    }
+
     SourceModelApp app;
 
     app.start();
 
+    if (RealtimeAudit::kEnabled) {
+        const auto counts = RealtimeAudit::counts();
+        std::printf("Audio thread: %llu allocations, %llu deallocations, %llu locks\n",
+                    (unsigned long long)counts.allocations,
+                    (unsigned long long)counts.deallocations,
+                    (unsigned long long)counts.locks);
+    }
+
+#ifndef __EMSCRIPTEN__
+    if (!wisdom.empty()) {
+        FFTPlanCache<Scalar>::instance().exportWisdom(wisdom.string());
+    }
+#endif
+
     std::exit(EXIT_SUCCESS);
 }
 
@@ -0,0 +1,50 @@
+#ifndef SOURCEMODEL__MATH_CUMULATIVE_INTEGRAL_H
+#define SOURCEMODEL__MATH_CUMULATIVE_INTEGRAL_H
+
+#include <vector>
+
+#include "utils.h"
+
+/* Integral of f from `from` to each of the increasing points t[0..n-1].
+ *
+ * Every interval between consecutive points is integrated once with 3-point
+ * Gauss-Legendre (exact up to degree 5) and the results are prefix-summed, so the
+ * whole curve costs 3n evaluations of f. Discontinuities of f should fall on the
+ * points. evaluateBlock(x, y, count) fills y with f(x), nodes and values are scratch
+ * space kept by the caller to avoid reallocating.
+ */
+template <typename BlockFn>
+void cumulativeIntegral(BlockFn&& evaluateBlock, const Scalar from, const Scalar* t,
+                        Scalar* out, const int n, std::vector<Scalar>& nodes,
+                        std::vector<Scalar>& values) {
+    static constexpr int    kOrder = 3;
+    static constexpr Scalar x[kOrder] = {-0.774596669241483377035853079956479922_f, 0,
+                                         0.774596669241483377035853079956479922_f};
+    static constexpr Scalar w[kOrder] = {5.0_f / 9.0_f, 8.0_f / 9.0_f, 5.0_f / 9.0_f};
+
+    nodes.resize(kOrder * n);
+    values.resize(kOrder * n);
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar a = i > 0 ? t[i - 1] : from;
+        const Scalar center = (a + t[i]) / 2;
+        const Scalar halfWidth = (t[i] - a) / 2;
+        for (int k = 0; k < kOrder; ++k) {
+            nodes[kOrder * i + k] = center + halfWidth * x[k];
+        }
+    }
+
+    evaluateBlock(nodes.data(), values.data(), kOrder * n);
+
+    Scalar sum = 0;
+    for (int i = 0; i < n; ++i) {
+        const Scalar a = i > 0 ? t[i - 1] : from;
+        const Scalar halfWidth = (t[i] - a) / 2;
+        for (int k = 0; k < kOrder; ++k) {
+            sum += halfWidth * w[k] * values[kOrder * i + k];
+        }
+        out[i] = sum;
+    }
+}
+
+#endif  // SOURCEMODEL__MATH_CUMULATIVE_INTEGRAL_H
@@ -5,11 +5,7 @@
 #include <fftw3cxx.hh>
 #include <vector>
 
-#ifdef __EMSCRIPTEN__
-    #define FFTW_SETTING FFTW_ESTIMATE
-#else
-    #define FFTW_SETTING FFTW_ESTIMATE
-#endif
+#include "FFTPlanCache.h"
 
 template <typename T>
 class DTFT {
@@ -26,8 +22,8 @@ class DTFT {
             m_output = (std::complex<T> *)fftw3cxx::malloc<T>((sampleCount / 2 + 1) *
                                                               sizeof(std::complex<T>));
             m_mag.resize(sampleCount / 2 + 1);
-            m_plan = fftw3cxx::plan<T>::plan_dft_r2c_1d(sampleCount, m_input, m_output,
-                                                        FFTW_SETTING);
+            // Shared with every other transform of the same size.
+            m_plan = FFTPlanCache<T>::instance().realForward(sampleCount);
         }
     }
 
@@ -41,7 +37,7 @@ class DTFT {
         }
 
         std::copy(&samples[0], &samples[sampleCount], &m_input[0]);
-        m_plan.execute();
+        m_plan.execute_dft_r2c(m_input, m_output);
 
         for (int i = 0; i < sampleCount / 2 + 1; ++i) {
             m_mag[i] = std::abs(m_output[i]) / sampleCount;
@@ -0,0 +1,107 @@
+#ifndef SOURCEMODEL__MATH_FFT_PLAN_CACHE_H
+#define SOURCEMODEL__MATH_FFT_PLAN_CACHE_H
+
+#include <complex>
+#include <fftw3cxx.hh>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+/* FFTW plans shared by the whole process, one per kind and size.
+ *
+ * Plans are made once on scratch arrays owned by the cache, so they can be measured
+ * (FFTW_MEASURE or FFTW_PATIENT) without clobbering the caller's data. Callers run
+ * them with the new-array execute functions on arrays from fftw3cxx::malloc, which
+ * have the alignment the plans expect. Importing wisdom saved by a previous run makes
+ * measured plans as cheap to create as estimated ones.
+ */
+template <typename T>
+class FFTPlanCache {
+   public:
+    using Plan = fftw3cxx::plan<T>;
+
+    static FFTPlanCache& instance() {
+        static FFTPlanCache cache;
+        return cache;
+    }
+
+    // Planner flags for plans that aren't cached yet.
+    unsigned flags() const { return m_flags; }
+    void     setFlags(const unsigned flags) { m_flags = flags; }
+
+    // Real to complex, out of place: execute_dft_r2c(in, out) with n real inputs and
+    // n / 2 + 1 complex outputs.
+    Plan realForward(const int n) {
+        return get(Kind_RealForward, n, [n](T* in, T* out, unsigned flags) {
+            return Plan::plan_dft_r2c_1d(n, in, toComplex(out), flags);
+        });
+    }
+
+    // Complex, in place: execute_dft(data, data) with n complex values.
+    Plan complexInPlace(const int n, const int sign) {
+        return get(sign == FFTW_FORWARD ? Kind_ComplexForward : Kind_ComplexBackward, n,
+                   [n, sign](T* in, T*, unsigned flags) {
+                       return Plan::plan_dft_1d(n, toComplex(in), toComplex(in), sign,
+                                                flags);
+                   });
+    }
+
+    bool importWisdom(const std::string& path) {
+        std::lock_guard lock(m_mutex);
+        return fftw3cxx::import_wisdom_from_filename<T>(path.c_str()) != 0;
+    }
+
+    bool exportWisdom(const std::string& path) {
+        std::lock_guard lock(m_mutex);
+        return fftw3cxx::export_wisdom_to_filename<T>(path.c_str()) != 0;
+    }
+
+   private:
+    enum Kind {
+        Kind_RealForward,
+        Kind_ComplexForward,
+        Kind_ComplexBackward,
+    };
+
+#ifdef __EMSCRIPTEN__
+    // Measuring in the browser would stall the page and there is no wisdom to keep.
+    FFTPlanCache() : m_flags(FFTW_ESTIMATE) {}
+#else
+    FFTPlanCache() : m_flags(FFTW_MEASURE) {}
+#endif
+
+    static std::complex<T>* toComplex(T* p) {
+        return reinterpret_cast<std::complex<T>*>(p);
+    }
+
+    template <typename MakePlan>
+    Plan get(const Kind kind, const int n, MakePlan&& makePlan) {
+        // The FFTW planner isn't thread-safe, executing plans is.
+        std::lock_guard lock(m_mutex);
+
+        const auto key = std::make_tuple(kind, n);
+        if (auto it = m_plans.find(key); it != m_plans.end()) {
+            return it->second;
+        }
+
+        // Separate allocations so that both arrays have the fftw3cxx::malloc alignment,
+        // each large enough for n complex values.
+        T* in = static_cast<T*>(fftw3cxx::malloc<T>(2 * n * sizeof(T)));
+        T* out = static_cast<T*>(fftw3cxx::malloc<T>(2 * n * sizeof(T)));
+
+        Plan plan = makePlan(in, out, m_flags);
+
+        fftw3cxx::free<T>(in);
+        fftw3cxx::free<T>(out);
+
+        m_plans.emplace(key, plan);
+        return plan;
+    }
+
+    unsigned                              m_flags;
+    std::mutex                            m_mutex;
+    std::map<std::tuple<Kind, int>, Plan> m_plans;
+};
+
+#endif  // SOURCEMODEL__MATH_FFT_PLAN_CACHE_H
@@ -0,0 +1,210 @@
+#ifndef SOURCEMODEL__MATH_VECTOR_MATH_H
+#define SOURCEMODEL__MATH_VECTOR_MATH_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "math/utils.h"
+
+/* Branch-free exp, log, sin_pi and cos_pi for use in loops over arrays.
+ *
+ * Everything is plain arithmetic, bit casts and selects so that the compiler can
+ * vectorize the calling loop for whatever instruction set it targets (SSE, AVX2,
+ * NEON, WASM SIMD) without intrinsics. Accuracy is within a few ulps of std::exp and
+ * boost::math::sin_pi over the ranges the glottal flow models use.
+ */
+namespace vmath {
+
+namespace detail {
+    template <typename T>
+    struct Traits;
+
+    template <>
+    struct Traits<double> {
+        using Bits = uint64_t;
+
+        static constexpr int    kMantissaBits = 52;
+        static constexpr int    kExponentBias = 1023;
+        static constexpr double kRoundMagic = 0x1.8p52;  // Adding it rounds to integer.
+        static constexpr double kExpMin = -708.0;
+        static constexpr double kExpMax = 709.0;
+        static constexpr double kLn2Hi = 0x1.62e42fee00000p-1;  // k * kLn2Hi is exact.
+        static constexpr double kLn2Lo = 0x1.a39ef35793c76p-33;
+        static constexpr int    kExpDegree = 12;
+        static constexpr int    kLogDegree = 11;  // In powers of s^2.
+        static constexpr int    kSinDegree = 10;  // In powers of x^2.
+    };
+
+    template <>
+    struct Traits<float> {
+        using Bits = uint32_t;
+
+        static constexpr int   kMantissaBits = 23;
+        static constexpr int   kExponentBias = 127;
+        static constexpr float kRoundMagic = 0x1.8p23f;
+        static constexpr float kExpMin = -87.0f;
+        static constexpr float kExpMax = 88.0f;
+        static constexpr float kLn2Hi = 0x1.63p-1f;
+        static constexpr float kLn2Lo = -0x1.bd0106p-13f;
+        static constexpr int   kExpDegree = 7;
+        static constexpr int   kLogDegree = 5;
+        static constexpr int   kSinDegree = 6;
+    };
+
+    using ScalarTraits = Traits<Scalar>;
+    using Bits = ScalarTraits::Bits;
+
+    constexpr long double kPi = 3.141592653589793238462643383279502884L;
+    constexpr long double kLn2 = 0.693147180559945309417232121458176568L;
+    constexpr long double kSqrt2 = 1.414213562373095048801688724209698079L;
+    constexpr long double kLog10e = 0.434294481903251827651128918916605082L;
+
+    // Taylor coefficients of exp(x), the argument is reduced to |x| <= ln(2) / 2.
+    constexpr auto kExpCoeffs = [] {
+        std::array<Scalar, ScalarTraits::kExpDegree + 1> c{};
+        long double                                      term = 1;
+        for (int n = 0; n <= ScalarTraits::kExpDegree; ++n) {
+            c[n] = Scalar(term);
+            term /= (n + 1);
+        }
+        return c;
+    }();
+
+    // Taylor coefficients of log((1 + s) / (1 - s)) / s in powers of s^2, for
+    // |s| <= (sqrt(2) - 1) / (sqrt(2) + 1).
+    constexpr auto kLogCoeffs = [] {
+        std::array<Scalar, ScalarTraits::kLogDegree + 1> c{};
+        for (int n = 0; n <= ScalarTraits::kLogDegree; ++n) {
+            c[n] = Scalar(2.0L / (2 * n + 1));
+        }
+        return c;
+    }();
+
+    // Taylor coefficients of sin(pi x) / x in powers of x^2, for |x| <= 1/2.
+    constexpr auto kSinPiCoeffs = [] {
+        std::array<Scalar, ScalarTraits::kSinDegree + 1> c{};
+        long double                                      term = kPi;
+        for (int n = 0; n <= ScalarTraits::kSinDegree; ++n) {
+            c[n] = Scalar(term);
+            term *= -kPi * kPi / ((2 * n + 2) * (2 * n + 3));
+        }
+        return c;
+    }();
+
+    // Unrolled at compile time, a loop here would keep the caller from vectorizing.
+    template <size_t N, size_t I = 0>
+    inline Scalar horner(const std::array<Scalar, N>& c, const Scalar x) {
+        if constexpr (I == N - 1) {
+            return c[I];
+        } else {
+            return c[I] + x * horner<N, I + 1>(c, x);
+        }
+    }
+}  // namespace detail
+
+// condition ? a : b, with both sides already evaluated. Written with masks because
+// a plain ternary isn't if-converted by GCC when a or b could raise an FP exception.
+inline Scalar select(const bool condition, const Scalar a, const Scalar b) {
+    using detail::Bits;
+    const Bits mask = -Bits(condition);
+    return std::bit_cast<Scalar>((std::bit_cast<Bits>(a) & mask) |
+                                 (std::bit_cast<Bits>(b) & ~mask));
+}
+
+inline Scalar exp(const Scalar x) {
+    using namespace detail;
+
+    constexpr Scalar kLog2e = Scalar(1 / kLn2);
+
+    constexpr Scalar kMin = ScalarTraits::kExpMin;
+    constexpr Scalar kMax = ScalarTraits::kExpMax;
+
+    const Scalar xc = select(x < kMin, kMin, select(x > kMax, kMax, x));
+
+    // k = round(x / ln(2)), read back as an integer from the low mantissa bits.
+    const Scalar kf = xc * kLog2e + ScalarTraits::kRoundMagic;
+    const Scalar k = kf - ScalarTraits::kRoundMagic;
+    const Bits   ki =
+        std::bit_cast<Bits>(kf) - std::bit_cast<Bits>(ScalarTraits::kRoundMagic);
+
+    const Scalar r = (xc - k * ScalarTraits::kLn2Hi) - k * ScalarTraits::kLn2Lo;
+    const Scalar p = horner(kExpCoeffs, r);
+
+    // 2^k built directly in the exponent field.
+    const Bits scaleBits = (ki + ScalarTraits::kExponentBias)
+                           << ScalarTraits::kMantissaBits;
+    const Scalar y = p * std::bit_cast<Scalar>(scaleBits);
+
+    return select(x < kMin, Scalar(0), y);
+}
+
+// For positive normal x, zero gives -inf.
+inline Scalar log(const Scalar x) {
+    using namespace detail;
+
+    constexpr Bits kMantissaMask = (Bits(1) << ScalarTraits::kMantissaBits) - 1;
+    constexpr Bits kOneBits = std::bit_cast<Bits>(Scalar(1));
+
+    // x = 2^e m with m in [1, 2), e read back through the low mantissa bits like k in
+    // exp.
+    const Bits   bits = std::bit_cast<Bits>(x);
+    const Scalar m = std::bit_cast<Scalar>((bits & kMantissaMask) | kOneBits);
+    const Bits   magicBits = std::bit_cast<Bits>(ScalarTraits::kRoundMagic);
+    const Scalar e =
+        std::bit_cast<Scalar>(magicBits + (bits >> ScalarTraits::kMantissaBits)) -
+        ScalarTraits::kRoundMagic - ScalarTraits::kExponentBias;
+
+    // Centre m on 1, in [sqrt(1/2), sqrt(2)).
+    const bool   high = m > Scalar(kSqrt2);
+    const Scalar mc = select(high, m * Scalar(0.5), m);
+    const Scalar ec = select(high, e + 1, e);
+
+    // log(m) = log((1 + s) / (1 - s)) with s = (m - 1) / (m + 1).
+    const Scalar s = (mc - 1) / (mc + 1);
+    const Scalar y = ec * Scalar(kLn2) + s * horner(kLogCoeffs, s * s);
+
+    return select(x > 0, y, -std::numeric_limits<Scalar>::infinity());
+}
+
+inline Scalar log10(const Scalar x) { return log(x) * Scalar(detail::kLog10e); }
+
+namespace detail {
+    // Splits x = k + r with k integer and |r| <= 1/2, returns r and the parity of k.
+    inline Scalar reduceHalf(const Scalar x, Bits& parity) {
+        const Scalar kf = x + ScalarTraits::kRoundMagic;
+        const Scalar k = kf - ScalarTraits::kRoundMagic;
+        parity = std::bit_cast<Bits>(kf) & 1;
+        return x - k;
+    }
+
+    // Flips the sign of y if parity is 1.
+    inline Scalar flipSign(const Scalar y, const Bits parity) {
+        constexpr int kSignShift = 8 * sizeof(Scalar) - 1;
+        return std::bit_cast<Scalar>(std::bit_cast<Bits>(y) ^ (parity << kSignShift));
+    }
+}  // namespace detail
+
+// sin(pi x) = (-1)^k sin(pi r)
+inline Scalar sin_pi(const Scalar x) {
+    using namespace detail;
+
+    Bits         parity;
+    const Scalar r = reduceHalf(x, parity);
+    return flipSign(r * horner(kSinPiCoeffs, r * r), parity);
+}
+
+// cos(pi x) = (-1)^k sin(pi (1/2 - |r|))
+inline Scalar cos_pi(const Scalar x) {
+    using namespace detail;
+
+    Bits         parity;
+    const Scalar s = Scalar(0.5) - std::abs(reduceHalf(x, parity));
+    return flipSign(s * horner(kSinPiCoeffs, s * s), parity);
+}
+
+}  // namespace vmath
+
+#endif  // SOURCEMODEL__MATH_VECTOR_MATH_H
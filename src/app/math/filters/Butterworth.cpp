@@ -110,11 +110,11 @@ bool Butterworth::coefficients(const FilterType filterType, const Scalar fs,
 
     for (int k = 0; k < m_sos.size(); ++k) {
         for (int i = 0; i < 3; ++i) {
-            m_sos[k][i] *= pow(gain, 1 / m_sos.size());
+            m_sos[k][i] *= pow(gain, 1.0_f / m_sos.size());
         }
     }
 
-    m_zi.resize(m_sos.size(), {0, 0});
+    resizeState();
 
     return true;
 }
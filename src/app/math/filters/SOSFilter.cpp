@@ -1,30 +1,87 @@
 #include "SOSFilter.h"
 
+#include <algorithm>
+#include <cassert>
+
 SOSFilter::SOSFilter(const std::vector<std::array<Scalar, 6>>& sos)
-    : m_sos(sos), m_zi(sos.size(), {0_f, 0_f}) {}
+    : m_sos(sos), m_channelCount(1) {
+    resizeState();
+}
 
 SOSFilter::SOSFilter(const std::vector<std::complex<Scalar>>& z,
                      const std::vector<std::complex<Scalar>>& p, const Scalar k)
     : SOSFilter(zpk2sos(z, p, k)) {}
 
-std::vector<Scalar> SOSFilter::filter(const std::vector<Scalar>& x) {
-    std::vector<Scalar> y(x.size());
-
-    for (int k = 0; k < x.size(); ++k) {
-        Scalar x_cur = x[k];
-        Scalar x_new;
-        for (int s = 0; s < m_sos.size(); ++s) {
-            x_new = m_sos[s][0] * x_cur + m_zi[s][0];
-            m_zi[s][0] = m_sos[s][1] * x_cur - m_sos[s][4] * x_new + m_zi[s][1];
-            m_zi[s][1] = m_sos[s][2] * x_cur - m_sos[s][5] * x_new;
-            x_cur = x_new;
+int SOSFilter::channelCount() const { return m_channelCount; }
+
+void SOSFilter::setChannelCount(const int channels) {
+    m_channelCount = std::max(channels, 1);
+    m_z1.assign(m_sos.size() * m_channelCount, 0);
+    m_z2.assign(m_sos.size() * m_channelCount, 0);
+}
+
+void SOSFilter::reset() {
+    std::fill(m_z1.begin(), m_z1.end(), 0);
+    std::fill(m_z2.begin(), m_z2.end(), 0);
+}
+
+void SOSFilter::process(Scalar* data, const int n) {
+    const int channels = m_channelCount;
+    const int frames = n / channels;
+    assert(n % channels == 0);
+
+    // One section at a time over the whole block, with its coefficients in registers.
+    for (int s = 0; s < m_sos.size(); ++s) {
+        const Scalar b0 = m_sos[s][0];
+        const Scalar b1 = m_sos[s][1];
+        const Scalar b2 = m_sos[s][2];
+        const Scalar a1 = m_sos[s][4];
+        const Scalar a2 = m_sos[s][5];
+
+        if (channels == 1) {
+            Scalar z1 = m_z1[s];
+            Scalar z2 = m_z2[s];
+
+            for (int i = 0; i < n; ++i) {
+                const Scalar x = data[i];
+                const Scalar y = b0 * x + z1;
+                z1 = b1 * x - a1 * y + z2;
+                z2 = b2 * x - a2 * y;
+                data[i] = y;
+            }
+
+            m_z1[s] = z1;
+            m_z2[s] = z2;
+        } else {
+            Scalar* z1 = &m_z1[s * channels];
+            Scalar* z2 = &m_z2[s * channels];
+
+            // The channels are independent, the inner loop runs them in SIMD lanes.
+            for (int i = 0; i < frames; ++i) {
+                Scalar* frame = &data[i * channels];
+                for (int c = 0; c < channels; ++c) {
+                    const Scalar x = frame[c];
+                    const Scalar y = b0 * x + z1[c];
+                    z1[c] = b1 * x - a1 * y + z2[c];
+                    z2[c] = b2 * x - a2 * y;
+                    frame[c] = y;
+                }
+            }
         }
-        y[k] = x_cur;
     }
+}
 
+std::vector<Scalar> SOSFilter::filter(const std::vector<Scalar>& x) {
+    std::vector<Scalar> y(x);
+    process(y.data(), y.size());
     return y;
 }
 
 const std::vector<std::array<Scalar, 6>>& SOSFilter::coefficients() const {
     return m_sos;
-}
\ No newline at end of file
+}
+
+void SOSFilter::resizeState() {
+    m_z1.resize(m_sos.size() * m_channelCount, 0);
+    m_z2.resize(m_sos.size() * m_channelCount, 0);
+}
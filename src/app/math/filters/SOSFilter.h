@@ -7,6 +7,12 @@
 
 #include "math/utils.h"
 
+/* Cascade of biquad sections in transposed direct form II.
+ *
+ * process works in place and doesn't allocate, so it is safe on the audio thread. With
+ * more than one channel, the samples are interleaved frames and every channel goes
+ * through the same sections with its own state, one SIMD lane per channel.
+ */
 class SOSFilter {
    public:
     SOSFilter(const std::vector<std::array<Scalar, 6>>& sos = {});
@@ -15,17 +21,37 @@ class SOSFilter {
     SOSFilter(const std::vector<std::complex<Scalar>>& z,
               const std::vector<std::complex<Scalar>>& p, Scalar k);
 
+    // Allocates and clears the state, call it outside of the audio thread.
+    int  channelCount() const;
+    void setChannelCount(int channels);
+
+    // Clears the state of every channel.
+    void reset();
+
+    // Filters n samples in place, n / channelCount() interleaved frames. n has to be a
+    // multiple of channelCount(), only whole frames are filtered.
+    void process(Scalar* data, int n);
+
+    // Same as process, into a new vector.
     std::vector<Scalar> filter(const std::vector<Scalar>& x);
 
     const std::vector<std::array<Scalar, 6>>& coefficients() const;
 
    protected:
+    // Matches the state to the number of sections, call it after changing m_sos.
+    void resizeState();
+
     std::vector<std::array<Scalar, 6>> m_sos;
-    std::vector<std::array<Scalar, 2>> m_zi;
+
+    int m_channelCount;
+
+    // State of section s for channel c at [s * m_channelCount + c].
+    std::vector<Scalar> m_z1;
+    std::vector<Scalar> m_z2;
 };
 
 std::vector<std::array<Scalar, 6>> zpk2sos(const std::vector<std::complex<Scalar>>& z,
                                            const std::vector<std::complex<Scalar>>& p,
                                            Scalar                                   k);
 
-#endif  // SOURCEMODEL__MATH_FILTERS_SOSFILTER_H
\ No newline at end of file
+#endif  // SOURCEMODEL__MATH_FILTERS_SOSFILTER_H
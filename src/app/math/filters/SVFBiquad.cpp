@@ -31,10 +31,13 @@ inline Scalar rcsqrtmul(const bool m1pos, const bool m2pos, const Scalar asm1,
     return (m1pos - !m1pos) * (asm1 * asm2);
 }
 
+SVFBiquad::SVFBiquad()
+    : _g(0), _R(0), _cHP(0), _cBP(0), _cLP(0), _rampRemaining(0), _z1(0), _z2(0) {
+    updateDerived();
+}
+
 void SVFBiquad::update(const Scalar b0, const Scalar b1, const Scalar b2, const Scalar a1,
                        const Scalar a2) {
-    using namespace std::complex_literals;
-
     const Scalar m1 = -1 - a1 - a2;
     const Scalar m2 = -1 + a1 - a2;
 
@@ -58,11 +61,97 @@ void SVFBiquad::update(const Scalar b0, const Scalar b1, const Scalar b2, const
     _cBP = (2 * (b0 - b2)) / sm1mul2;
     _cLP = (b0 + b1 + b2) / (1 + a1 + a2);
 
-    _HP.update(_g, _R, SVFPiece::FltType_HIGHPASS);
-    _BP.update(_g, _R, SVFPiece::FltType_BANDPASS);
-    _LP.update(_g, _R, SVFPiece::FltType_LOWPASS);
+    _rampRemaining = 0;
+    updateDerived();
+}
+
+void SVFBiquad::rampTo(const Scalar b0, const Scalar b1, const Scalar b2, const Scalar a1,
+                       const Scalar a2, const int length) {
+    const Scalar g = _g;
+    const Scalar R = _R;
+    const Scalar cHP = _cHP;
+    const Scalar cBP = _cBP;
+    const Scalar cLP = _cLP;
+
+    update(b0, b1, b2, a1, a2);
+
+    if (length > 1) {
+        _dg = (_g - g) / length;
+        _dR = (_R - R) / length;
+        _dcHP = (_cHP - cHP) / length;
+        _dcBP = (_cBP - cBP) / length;
+        _dcLP = (_cLP - cLP) / length;
+
+        // Start from where we were, the first tick takes the first step.
+        _g = g;
+        _R = R;
+        _cHP = cHP;
+        _cBP = cBP;
+        _cLP = cLP;
+        _rampRemaining = length;
+        updateDerived();
+    }
 }
 
 Scalar SVFBiquad::tick(const Scalar x) {
-    return _cHP * _HP.tick(x) + _cBP * _BP.tick(x) + _cLP * _LP.tick(x);
-}
\ No newline at end of file
+    if (_rampRemaining > 0) {
+        stepRamp();
+    }
+
+    const Scalar HP = (x - _R2g * _z1 - _z2) * _invDen;
+    const Scalar BP = HP * _g + _z1;
+    const Scalar LP = BP * _g + _z2;
+
+    _z1 = _g * HP + BP;
+    _z2 = _g * BP + LP;
+
+    return _cHP * HP + _cBP * BP + _cLP * LP;
+}
+
+void SVFBiquad::process(const Scalar* in, Scalar* out, const int n) {
+    int i = 0;
+
+    for (; i < n && _rampRemaining > 0; ++i) {
+        out[i] = tick(in[i]);
+    }
+
+    // Coefficients are constant from here, keep everything in registers.
+    const Scalar g = _g;
+    const Scalar R2g = _R2g;
+    const Scalar invDen = _invDen;
+    const Scalar cHP = _cHP;
+    const Scalar cBP = _cBP;
+    const Scalar cLP = _cLP;
+
+    Scalar z1 = _z1;
+    Scalar z2 = _z2;
+
+    for (; i < n; ++i) {
+        const Scalar HP = (in[i] - R2g * z1 - z2) * invDen;
+        const Scalar BP = HP * g + z1;
+        const Scalar LP = BP * g + z2;
+
+        z1 = g * HP + BP;
+        z2 = g * BP + LP;
+
+        out[i] = cHP * HP + cBP * BP + cLP * LP;
+    }
+
+    _z1 = z1;
+    _z2 = z2;
+}
+
+void SVFBiquad::stepRamp() {
+    _g += _dg;
+    _R += _dR;
+    _cHP += _dcHP;
+    _cBP += _dcBP;
+    _cLP += _dcLP;
+    _rampRemaining--;
+    updateDerived();
+}
+
+void SVFBiquad::updateDerived() {
+    _R2g = 2 * _R + _g;
+    _invDen = 1 / (1 + 2 * _R * _g + _g * _g);
+}
@@ -1,26 +1,55 @@
 #ifndef SVF_BIQUAD_H
 #define SVF_BIQUAD_H
 
-#include "SVFPiece.h"
+#include "math/utils.h"
 
-/* Biquad realized with SVFs */
+/* Biquad realized with an SVF
+ *
+ * The highpass, bandpass and lowpass outputs of a single TDF-II SVF are mixed with
+ * _cHP, _cBP and _cLP, so there is one state pair and one multiply by the reciprocal
+ * of the denominator per sample.
+ */
 
 class SVFBiquad {
    public:
+    SVFBiquad();
+
     void update(Scalar b0, Scalar b1, Scalar b2, Scalar a1, Scalar a2);
 
+    // Same as update, but the SVF coefficients glide linearly from their current values
+    // and reach the new ones after `length` ticks. SVFs stay well-behaved under this
+    // kind of modulation, unlike direct forms.
+    void rampTo(Scalar b0, Scalar b1, Scalar b2, Scalar a1, Scalar a2, int length);
+
     Scalar tick(Scalar x);
 
+    // Same as calling tick on each sample. in and out may be the same buffer.
+    void process(const Scalar* in, Scalar* out, int n);
+
    private:
+    void stepRamp();
+    void updateDerived();
+
     Scalar _g;
     Scalar _R;
     Scalar _cHP;
     Scalar _cBP;
     Scalar _cLP;
 
-    SVFPiece _HP;
-    SVFPiece _BP;
-    SVFPiece _LP;
+    // Derived from g and R.
+    Scalar _R2g;     // 2R + g
+    Scalar _invDen;  // 1 / (1 + 2Rg + g^2)
+
+    // Per-tick increments while ramping.
+    int    _rampRemaining;
+    Scalar _dg;
+    Scalar _dR;
+    Scalar _dcHP;
+    Scalar _dcBP;
+    Scalar _dcLP;
+
+    Scalar _z1;
+    Scalar _z2;
 };
 
-#endif  // SVF_BIQUAD_H
\ No newline at end of file
+#endif  // SVF_BIQUAD_H
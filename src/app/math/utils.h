@@ -1,6 +1,7 @@
 #ifndef SOURCEMODEL__MATH_UTILS_H
 #define SOURCEMODEL__MATH_UTILS_H
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -32,4 +33,28 @@ inline int nextpow2(const T a) {
     }
 }
 
+// Monotone cubic Hermite interpolation between y1 and y2 at x in [0, 1], for samples
+// y0..y3 on a uniform grid. Tangents are Catmull-Rom's central differences, limited
+// (Fritsch-Carlson) so that the result never overshoots the data around kinks.
+template <typename T>
+inline T monotoneCubic(const T y0, const T y1, const T y2, const T y3, const T x) {
+    const auto tangent = [](const T d0, const T d1) {
+        if (d0 * d1 <= 0) {
+            return T(0);
+        }
+        const T m = (d0 + d1) / 2;
+        const T limit = 3 * std::min(std::abs(d0), std::abs(d1));
+        return std::abs(m) <= limit ? m : std::copysign(limit, m);
+    };
+
+    const T d = y2 - y1;
+    const T m1 = tangent(y1 - y0, d);
+    const T m2 = tangent(d, y3 - y2);
+
+    // Hermite basis in Horner form.
+    const T c2 = 3 * d - 2 * m1 - m2;
+    const T c3 = m1 + m2 - 2 * d;
+    return y1 + x * (m1 + x * (c2 + x * c3));
+}
+
 #endif  // SOURCEMODEL__MATH_UTILS_H
\ No newline at end of file
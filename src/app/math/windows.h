@@ -11,11 +11,7 @@
 #include <iostream>
 #include <vector>
 
-#ifdef __EMSCRIPTEN__
-    #define FFTW_SETTING FFTW_ESTIMATE
-#else
-    #define FFTW_SETTING FFTW_ESTIMATE
-#endif
+#include "FFTPlanCache.h"
 
 namespace windows {
 
@@ -274,10 +270,11 @@ std::vector<T> chebwin(int M, const T at, const bool sym = true) {
         x[i] = beta * cos_pi(T(i) / T(M));
     }
 
-    std::vector<std::complex<T>> p(M);
+    // From fftw3cxx::malloc to have the alignment of the shared plan.
+    auto p = static_cast<std::complex<T>*>(
+        fftw3cxx::malloc<T>(M * sizeof(std::complex<T>)));
 
-    auto plan =
-        fftw3cxx::plan<T>::plan_dft_1d(M, p.data(), p.data(), FFTW_FORWARD, FFTW_SETTING);
+    auto plan = FFTPlanCache<T>::instance().complexInPlace(M, FFTW_FORWARD);
 
     // Find the window's DFT coefficients
     // Use analytic definition of Chebyshev polynomial instead of expansion
@@ -293,7 +290,7 @@ std::vector<T> chebwin(int M, const T at, const bool sym = true) {
 
     // Appropriate IDFT and filling up depending on even/odd M.
     if (M % 2 != 0) {
-        plan.execute();
+        plan.execute_dft(p, p);
 
         const int n = (M + 1) / 2;
         for (int i = 0; i < n; ++i) {
@@ -306,7 +303,7 @@ std::vector<T> chebwin(int M, const T at, const bool sym = true) {
             p[i] = std::polar(std::real(p[i]), pi<T>() / M * i);
         }
 
-        plan.execute();
+        plan.execute_dft(p, p);
 
         const int n = M / 2 + 1;
         for (int i = 1; i < n; ++i) {
@@ -316,6 +313,8 @@ std::vector<T> chebwin(int M, const T at, const bool sym = true) {
         }
     }
 
+    fftw3cxx::free<T>(p);
+
     // Scale.
     T maxW = std::numeric_limits<T>::min();
     for (int i = 0; i < M; ++i) {
@@ -2,6 +2,8 @@
 
 #include <cmath>
 
+#include "../math/VectorMath.h"
+
 using namespace models;
 
 Scalar KLGLOTT88::evaluate(Scalar t) const {
@@ -34,6 +36,27 @@ Scalar KLGLOTT88::evaluateAntiderivative(Scalar t) const {
     return g;
 }
 
+void KLGLOTT88::evaluateBlock(const Scalar* t, Scalar* out, const int n) const {
+    const Scalar a = 2.0_f / m_Oq;
+    const Scalar b = 3.0_f / (m_Oq * m_Oq);
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar dg = t[i] * (a - b * t[i]);
+        out[i] = vmath::select(t[i] <= m_Oq, dg, 0.0_f);
+    }
+}
+
+void KLGLOTT88::evaluateAntiderivativeBlock(const Scalar* t, Scalar* out,
+                                            const int n) const {
+    const Scalar a = 1.0_f / (m_Oq * m_Oq);
+    const Scalar b = a / m_Oq;
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar g = t[i] * t[i] * (a - b * t[i]);
+        out[i] = vmath::select(t[i] <= m_Oq, g, 0.0_f);
+    }
+}
+
 void KLGLOTT88::fitParameters(GlottalFlowParameters& params) { m_Oq = params.Oq.value(); }
 
 void KLGLOTT88::updateParameterBounds(GlottalFlowParameters& params) {
@@ -13,6 +13,9 @@ class KLGLOTT88 : public GlottalFlowModel {
     Scalar evaluate(Scalar t) const override;
     Scalar evaluateAntiderivative(Scalar t) const override;
 
+    void evaluateBlock(const Scalar* t, Scalar* out, int n) const override;
+    void evaluateAntiderivativeBlock(const Scalar* t, Scalar* out, int n) const override;
+
     void fitParameters(GlottalFlowParameters& params) override;
     void updateParameterBounds(GlottalFlowParameters& params) override;
 
@@ -1,16 +1,17 @@
 #include "LF.h"
 
+#include <algorithm>
 #include <array>
 #include <boost/math/constants/constants.hpp>
-#include <boost/math/quadrature/gauss_kronrod.hpp>
 #include <boost/math/special_functions/cos_pi.hpp>
 #include <boost/math/special_functions/sin_pi.hpp>
 #include <boost/math/tools/roots.hpp>
 #include <iostream>
 
+#include "../math/VectorMath.h"
+
 namespace math = boost::math;
 using namespace boost::math::constants;
-using namespace boost::math::quadrature;
 using namespace models;
 using namespace models::precomp;
 using boost::math::cos_pi;
@@ -51,21 +52,106 @@ Scalar LF::evaluateAntiderivative(Scalar t) const {
             (m_alpha * m_alpha + pi_sqr<Scalar>() / (m_Tp * m_Tp)) *
             (pi<Scalar>() / m_Tp + m_alpha * std::exp(m_alpha * t) * sin_pi(t / m_Tp) -
              pi<Scalar>() / m_Tp * std::exp(m_alpha * t) * cos_pi(t / m_Tp));
+    } else if (!std::isinf(m_epsilon) && !std::isnan(m_epsilon)) {
+        // Integral of the return phase from Te, both of its terms integrate exactly.
+        const Scalar u = t - m_Te;
+        g = m_gTe - m_Ee / (m_epsilon * m_Ta) *
+                        (-std::expm1(-m_epsilon * u) / m_epsilon -
+                         u * std::exp(-m_epsilon * (T0 - m_Te)));
     } else {
-        // Start integrating from Te.
-        // Doing it this way means we are integrating a smooth function.
-        const auto& fn = [this](Scalar t) -> Scalar { return evaluate(t); };
-
-        // Float / double
-#if defined(USING_SINGLE_FLOAT)
-        g = m_gTe + gauss_kronrod<float, 15>::integrate(fn, m_Te, t, 3, 1e-3);
-#elif defined(USING_DOUBLE_FLOAT)
-        g = m_gTe + gauss_kronrod<double, 31>::integrate(fn, m_Te, t, 3, 1e-3);
-#endif
+        g = m_gTe;
     }
     return g;
 }
 
+void LF::evaluateBlock(const Scalar* t, Scalar* out, const int n) const {
+    static constexpr Scalar T0 = 1;
+
+    // Members are copied to locals, GCC doesn't vectorize if they're read in the loop.
+    const Scalar Te = m_Te;
+    const Scalar alpha = m_alpha;
+    const Scalar openGain = -m_Ee / sin_pi(m_Te / m_Tp);
+    const Scalar invTp = 1 / m_Tp;
+
+    const bool   hasReturnPhase = !std::isinf(m_epsilon) && !std::isnan(m_epsilon);
+    const Scalar epsilon = hasReturnPhase ? m_epsilon : 0;
+    const Scalar returnGain = hasReturnPhase ? -m_Ee / (m_epsilon * m_Ta) : 0;
+    const Scalar returnEnd = hasReturnPhase ? std::exp(-m_epsilon * (T0 - m_Te)) : 0;
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar opening =
+            openGain * vmath::exp(alpha * (t[i] - Te)) * vmath::sin_pi(t[i] * invTp);
+        const Scalar closing =
+            returnGain * (vmath::exp(-epsilon * (t[i] - Te)) - returnEnd);
+        out[i] = vmath::select(t[i] <= Te, opening, closing);
+    }
+}
+
+void LF::evaluateAntiderivativeBlock(const Scalar* t, Scalar* out, const int n) const {
+    static constexpr Scalar T0 = 1;
+
+    const Scalar Te = m_Te;
+    const Scalar alpha = m_alpha;
+    const Scalar a2 = m_alpha * m_alpha + pi_sqr<Scalar>() / (m_Tp * m_Tp);
+    const Scalar gain = -(m_Ee * std::exp(-m_alpha * m_Te)) / sin_pi(m_Te / m_Tp) / a2;
+    const Scalar w = pi<Scalar>() / m_Tp;
+    const Scalar invTp = 1 / m_Tp;
+
+    const bool   hasReturnPhase = !std::isinf(m_epsilon) && !std::isnan(m_epsilon);
+    const Scalar gTe = m_gTe;
+    const Scalar epsilon = hasReturnPhase ? m_epsilon : 0;
+    const Scalar invEpsilon = hasReturnPhase ? 1 / m_epsilon : 0;
+    const Scalar returnGain = hasReturnPhase ? -m_Ee / (m_epsilon * m_Ta) : 0;
+    const Scalar returnEnd = hasReturnPhase ? std::exp(-m_epsilon * (T0 - m_Te)) : 0;
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar e = vmath::exp(alpha * t[i]);
+        const Scalar opening = gain * (w + e * (alpha * vmath::sin_pi(t[i] * invTp) -
+                                                w * vmath::cos_pi(t[i] * invTp)));
+
+        // Same closed form as evaluateAntiderivative.
+        const Scalar u = t[i] - Te;
+        const Scalar rise = (1 - vmath::exp(-epsilon * u)) * invEpsilon;
+        const Scalar closing = gTe + returnGain * (rise - u * returnEnd);
+
+        out[i] = vmath::select(t[i] <= Te, opening, closing);
+    }
+}
+
+std::tuple<Scalar, Scalar, Scalar, Scalar, Scalar> LF::interpolateRd(const Scalar Rd,
+                                                                     const int  stride) {
+    const int    last = (Rd_table.size() - 1) / stride;
+    const Scalar step = stride * Rd_step;
+
+    const Scalar RdClamped = std::clamp<Scalar>(Rd, Rd_min, Rd_min + last * step);
+    const Scalar x = (RdClamped - Rd_min) / step;
+    const int    i = std::min(int(x), last - 1);
+    const Scalar frac = x - i;
+
+    // alpha goes like 1 / Te at low Rd, alpha * Te is much smoother.
+    // 1 / epsilon goes to zero with Ta instead of blowing up.
+    const auto row = [stride](const int j) {
+        const auto [Te, Tp, Ta, alpha, epsilon] = Rd_table[j * stride];
+        return std::array<Scalar, 5>{Te, Tp, Ta, alpha * Te, 1 / epsilon};
+    };
+
+    const auto r0 = row(std::max(i - 1, 0));
+    const auto r1 = row(i);
+    const auto r2 = row(i + 1);
+    const auto r3 = row(std::min(i + 2, last));
+
+    std::array<Scalar, 5> p;
+    for (int k = 0; k < 5; ++k) {
+        // Extrapolate linearly past both ends of the table.
+        const Scalar y0 = i > 0 ? r0[k] : 2 * r1[k] - r2[k];
+        const Scalar y3 = i + 2 <= last ? r3[k] : 2 * r2[k] - r1[k];
+        p[k] = monotoneCubic(y0, r1[k], r2[k], y3, frac);
+    }
+
+    const Scalar epsilon = p[4] > 0 ? 1 / p[4] : std::numeric_limits<Scalar>::infinity();
+    return {p[0], p[1], std::max<Scalar>(p[2], 0), p[3] / p[0], epsilon};
+}
+
 void LF::fitParameters(GlottalFlowParameters& params) {
     static constexpr Scalar Ee = 1;
     static constexpr Scalar T0 = 1;
@@ -83,12 +169,8 @@ void LF::fitParameters(GlottalFlowParameters& params) {
 
         fitParameters(Ee, T0, Te, Tp, Ta);
     } else {
-        // Just interpolate the pre-computed values.
-        const Scalar Rd = params.Rd.value();
-        const int    index = std::floor((Rd - Rd_min) / Rd_step);
-
         m_Ee = Ee;
-        std::tie(m_Te, m_Tp, m_Ta, m_alpha, m_epsilon) = Rd_table[index];
+        std::tie(m_Te, m_Tp, m_Ta, m_alpha, m_epsilon) = interpolateRd(params.Rd.value());
 
         // T0 = 1
 
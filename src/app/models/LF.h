@@ -2,6 +2,7 @@
 #define SOURCEMODEL__MODELS_LF_H
 
 #include <array>
+#include <tuple>
 #include <utility>
 
 #include "../GlottalFlowModel.h"
@@ -16,12 +17,25 @@ class LF : public GlottalFlowModel {
     Scalar evaluate(Scalar t) const override;
     Scalar evaluateAntiderivative(Scalar t) const override;
 
+    void evaluateBlock(const Scalar* t, Scalar* out, int n) const override;
+    void evaluateAntiderivativeBlock(const Scalar* t, Scalar* out, int n) const override;
+
     void fitParameters(GlottalFlowParameters& params) override;
     void updateParameterBounds(GlottalFlowParameters& params) override;
 
     // Specific to LF model, get Te directly, used for when Rd is used.
     Scalar Te() const;
 
+    // (Te, Tp, Ta, alpha, epsilon) for a given Rd, interpolated from the precomputed
+    // table with monotone cubics. Rd is clamped to the table range.
+    // A stride > 1 only reads every stride-th row, as if the table were coarser.
+    // Against the precompute tool, at twice the table step the error relative to each
+    // parameter's range stays below 1e-6 for Te, Tp and Ta and 3e-5 for alpha and
+    // 1 / epsilon, except next to the kinks of the Rd regression (Rd = 0.21, 1.8476
+    // and 2.7). See the lf-rd-lookup benchmark.
+    static std::tuple<Scalar, Scalar, Scalar, Scalar, Scalar> interpolateRd(
+        Scalar Rd, int stride = 1);
+
    private:
     void fitParameters(Scalar Ee, Scalar T0, Scalar Te, Scalar Tp, Scalar Ta);
 
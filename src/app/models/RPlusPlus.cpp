@@ -2,6 +2,7 @@
 
 #include <boost/math/constants/constants.hpp>
 
+#include "../math/VectorMath.h"
 #include "../math/utils.h"
 
 using namespace boost::math::constants;
@@ -51,6 +52,37 @@ Scalar RPlusPlus::evaluateAntiderivative(Scalar t) const {
     return g;
 }
 
+void RPlusPlus::evaluateBlock(const Scalar* t, Scalar* out, const int n) const {
+    const bool   hasReturnPhase = m_Ta > 1e-6;
+    const Scalar invTa = hasReturnPhase ? 1 / m_Ta : 0;
+    const Scalar returnGain = hasReturnPhase ? m_dgTe / (1 - m_expT0TeTa) : 0;
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar opening = 4 * m_K * t[i] * (m_Tp - t[i]) * (m_Tx - t[i]);
+        const Scalar closing =
+            returnGain * (vmath::exp(-(t[i] - m_Te) * invTa) - m_expT0TeTa);
+        out[i] = vmath::select(t[i] <= m_Te, opening, closing);
+    }
+}
+
+void RPlusPlus::evaluateAntiderivativeBlock(const Scalar* t, Scalar* out,
+                                            const int n) const {
+    const bool   hasReturnPhase = m_Ta > 1e-6;
+    const Scalar invTa = hasReturnPhase ? 1 / m_Ta : 0;
+    const Scalar returnGain = hasReturnPhase ? m_Ta * m_dgTe / (1 - m_expT0TeTa) : 0;
+    const Scalar returnOffset = hasReturnPhase ? m_gTe : 0;
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar opening =
+            m_K * t[i] * t[i] *
+            (t[i] * t[i] - four_thirds * t[i] * (m_Tp + m_Tx) + 2 * m_Tp * m_Tx);
+        const Scalar x = (t[i] - m_Te) * invTa;
+        const Scalar closing =
+            returnOffset + returnGain * (1.0_f - vmath::exp(-x) - x * m_expT0TeTa);
+        out[i] = vmath::select(t[i] <= m_Te, opening, closing);
+    }
+}
+
 void RPlusPlus::fitParameters(GlottalFlowParameters& params) {
     static constexpr Scalar E = 1;
     static constexpr Scalar T0 = 1;
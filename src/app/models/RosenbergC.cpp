@@ -4,6 +4,8 @@
 #include <boost/math/special_functions/cos_pi.hpp>
 #include <boost/math/special_functions/sin_pi.hpp>
 
+#include "../math/VectorMath.h"
+
 using namespace boost::math::constants;
 using namespace models;
 using boost::math::cos_pi;
@@ -43,6 +45,35 @@ Scalar RosenbergC::evaluateAntiderivative(Scalar t) const {
     return g;
 }
 
+void RosenbergC::evaluateBlock(const Scalar* t, Scalar* out, const int n) const {
+    // Members are copied to locals, GCC doesn't vectorize if they're read in the loop.
+    const Scalar Tp = m_Tp;
+    const Scalar Tn = m_Tn;
+    const Scalar gp = half_pi<Scalar>() * m_A / Tp;
+    const Scalar gn = -half_pi<Scalar>() * m_A / Tn;
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar opening = gp * vmath::sin_pi(t[i] / Tp);
+        const Scalar closing = gn * vmath::sin_pi(0.5_f * (t[i] - Tp) / Tn);
+        out[i] = vmath::select(t[i] <= Tp, opening,
+                               vmath::select(t[i] <= Tp + Tn, closing, 0.0_f));
+    }
+}
+
+void RosenbergC::evaluateAntiderivativeBlock(const Scalar* t, Scalar* out,
+                                             const int n) const {
+    const Scalar Tp = m_Tp;
+    const Scalar Tn = m_Tn;
+    const Scalar A = m_A;
+
+    for (int i = 0; i < n; ++i) {
+        const Scalar opening = A / 2.0_f * (1.0_f - vmath::cos_pi(t[i] / Tp));
+        const Scalar closing = A * vmath::cos_pi(0.5_f * (t[i] - Tp) / Tn);
+        out[i] = vmath::select(t[i] <= Tp, opening,
+                               vmath::select(t[i] <= Tp + Tn, closing, 0.0_f));
+    }
+}
+
 void RosenbergC::fitParameters(GlottalFlowParameters& params) {
     const Scalar Oq = params.Oq.value();
     const Scalar am = params.am.value();
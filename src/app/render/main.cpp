@@ -0,0 +1,362 @@
+#include <argparse.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FormantGenerator.h"
+#include "GlottalFlow.h"
+#include "SourceGenerator.h"
+#include "VoiceBank.h"
+#include "audio/RealtimeAudit.h"
+#include "audio/SampleClock.h"
+#include "audio/WorkerPool.h"
+#include "math/utils.h"
+
+static_assert(std::endian::native == std::endian::little,
+              "Output files are written in host byte order");
+
+namespace {
+
+enum OutputFormat {
+    OutputFormat_Wav,
+    OutputFormat_Raw,
+};
+
+bool parseModelType(const std::string& name, GlottalFlowModelType& type) {
+    // GlottalFlowModel_NAMES is a list of null-terminated strings in enum order.
+    const char* it = GlottalFlowModel_NAMES;
+    for (int i = 0; *it != '\0'; ++i, it += std::char_traits<char>::length(it) + 1) {
+        if (name == it) {
+            type = static_cast<GlottalFlowModelType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+void writeLE(std::FILE* file, const T value) {
+    std::fwrite(&value, sizeof(T), 1, file);
+}
+
+bool writeOutput(const std::string& path, const OutputFormat format, const int fs,
+                 const std::vector<float>& samples) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::perror("Error opening the output file");
+        return false;
+    }
+
+    if (format == OutputFormat_Wav) {
+        // 32-bit IEEE float mono WAV.
+        const uint32_t dataBytes = samples.size() * sizeof(float);
+        std::fwrite("RIFF", 1, 4, file);
+        writeLE<uint32_t>(file, 36 + dataBytes);
+        std::fwrite("WAVE", 1, 4, file);
+        std::fwrite("fmt ", 1, 4, file);
+        writeLE<uint32_t>(file, 16);
+        writeLE<uint16_t>(file, 3);  // WAVE_FORMAT_IEEE_FLOAT
+        writeLE<uint16_t>(file, 1);  // Mono
+        writeLE<uint32_t>(file, fs);
+        writeLE<uint32_t>(file, fs * sizeof(float));
+        writeLE<uint16_t>(file, sizeof(float));
+        writeLE<uint16_t>(file, 8 * sizeof(float));
+        std::fwrite("data", 1, 4, file);
+        writeLE<uint32_t>(file, dataBytes);
+    }
+
+    const size_t written = std::fwrite(samples.data(), sizeof(float), samples.size(), file);
+    std::fclose(file);
+
+    if (written != samples.size()) {
+        std::cerr << "Error writing the output file." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    argparse::ArgumentParser program("SourceModelRender", "1.0");
+
+    program.add_argument("output").required().help("output file (.wav or .raw)");
+    program.add_argument("-d", "--duration")
+        .default_value(5.0)
+        .scan<'g', double>()
+        .help("rendered duration in seconds");
+    program.add_argument("-r", "--sample-rate")
+        .default_value(48000)
+        .scan<'i', int>()
+        .help("sample rate in Hz");
+    program.add_argument("-b", "--block-size")
+        .default_value(1024)
+        .scan<'i', int>()
+        .help("samples rendered per block, like an audio callback would");
+    program.add_argument("--format")
+        .default_value(std::string("auto"))
+        .help("output format: wav, raw (32-bit float) or auto (from extension)");
+    program.add_argument("--model")
+        .default_value(std::string("LF"))
+        .help("glottal flow model: LF, R++, Rosenberg-C or KLGLOTT88");
+    program.add_argument("--f0").default_value(120.0).scan<'g', double>().help(
+        "fundamental frequency in Hz");
+    program.add_argument("--Rd").default_value(0.32).scan<'g', double>().help(
+        "Rd waveshape parameter (LF model only)");
+    program.add_argument("--bypass-filter")
+        .default_value(false)
+        .implicit_value(true)
+        .help("output the glottal source without the formant filter");
+    program.add_argument("--parallel-formants")
+        .default_value(false)
+        .implicit_value(true)
+        .help("run the formants in parallel (Klatt) instead of in cascade");
+    program.add_argument("--preroll")
+        .default_value(0.25)
+        .scan<'g', double>()
+        .help("seconds rendered and discarded before the output starts");
+
+    program.add_argument("--oversample")
+        .default_value(1)
+        .scan<'i', int>()
+        .help("source oversampling factor: 1, 2, 4 or 8");
+    program.add_argument("--control-period")
+        .default_value(FormantGenerator::kDefaultControlPeriod)
+        .scan<'i', int>()
+        .help("samples between formant parameter updates (1 = every sample)");
+    program.add_argument("--voices")
+        .default_value(0)
+        .scan<'i', int>()
+        .help("render N detuned voices with the voice bank instead of a single voice");
+    program.add_argument("--threads")
+        .default_value(0)
+        .scan<'i', int>()
+        .help("worker threads for the voice bank (0 = one per core)");
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::runtime_error& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        std::exit(EXIT_FAILURE);
+    }
+
+    const std::string outputPath = program.get("output");
+    const double      duration = program.get<double>("--duration");
+    const int         fs = program.get<int>("--sample-rate");
+    const int         blockSize = program.get<int>("--block-size");
+    const double      preroll = program.get<double>("--preroll");
+    const bool        doBypassFilter = program.get<bool>("--bypass-filter");
+    const int         voiceCount = program.get<int>("--voices");
+    const int         oversampling = program.get<int>("--oversample");
+    const int         controlPeriod = program.get<int>("--control-period");
+
+    if (duration <= 0 || fs <= 0 || blockSize <= 0 || preroll < 0 || voiceCount < 0 ||
+        controlPeriod <= 0) {
+        std::cerr << "Duration, sample rate, block size, voice count and control period "
+                     "must be positive."
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (voiceCount > 0 && doBypassFilter) {
+        std::cerr << "The voice bank always filters, --bypass-filter can't be used with "
+                     "--voices."
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (oversampling != 1 && oversampling != 2 && oversampling != 4 && oversampling != 8) {
+        std::cerr << "Oversampling factor must be 1, 2, 4 or 8." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    OutputFormat format;
+    const std::string formatName = program.get("--format");
+    if (formatName == "wav") {
+        format = OutputFormat_Wav;
+    } else if (formatName == "raw") {
+        format = OutputFormat_Raw;
+    } else if (formatName == "auto") {
+        const bool isRaw = outputPath.size() >= 4 &&
+                           outputPath.compare(outputPath.size() - 4, 4, ".raw") == 0;
+        format = isRaw ? OutputFormat_Raw : OutputFormat_Wav;
+    } else {
+        std::cerr << "Unknown output format: " << formatName << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    GlottalFlowModelType modelType;
+    if (!parseModelType(program.get("--model"), modelType)) {
+        std::cerr << "Unknown glottal flow model: " << program.get("--model")
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Same generator chain as SourceModelApp, driven by a synthetic clock.
+    SampleClock         clock(fs);
+    GlottalFlow         glottalFlow;
+    SourceGenerator     sourceGenerator(clock, glottalFlow);
+    std::vector<Scalar> intermediateBuffer(blockSize);
+    FormantGenerator    formantGenerator(clock, intermediateBuffer);
+
+    glottalFlow.parameters().Oq.valueChanged.connect(&SourceGenerator::handleParamChanged,
+                                                     &sourceGenerator);
+    glottalFlow.parameters().am.valueChanged.connect(&SourceGenerator::handleParamChanged,
+                                                     &sourceGenerator);
+    glottalFlow.parameters().Qa.valueChanged.connect(&SourceGenerator::handleParamChanged,
+                                                     &sourceGenerator);
+    glottalFlow.parameters().usingRdChanged.connect(
+        &SourceGenerator::handleUsingRdChanged, &sourceGenerator);
+    glottalFlow.parameters().Rd.valueChanged.connect(&SourceGenerator::handleParamChanged,
+                                                     &sourceGenerator);
+    glottalFlow.modelTypeChanged.connect(&SourceGenerator::handleModelChanged,
+                                         &sourceGenerator);
+
+    glottalFlow.setModelType(modelType);
+    glottalFlow.parameters().setUsingRd(modelType == GlottalFlowModel_LF);
+    glottalFlow.parameters().Rd.setValue(program.get<double>("--Rd"));
+    sourceGenerator.pitch().setValue(program.get<double>("--f0"));
+
+    sourceGenerator.setSampleRate(fs);
+    formantGenerator.setSampleRate(fs);
+    sourceGenerator.setOversampling(oversampling);
+    formantGenerator.setControlPeriod(controlPeriod);
+    formantGenerator.parallelToggle().setValue(program.get<bool>("--parallel-formants"));
+    sourceGenerator.setNormalized(true);
+    formantGenerator.setNormalized(false);
+    sourceGenerator.prepare(blockSize);
+    formantGenerator.prepare(blockSize);
+
+    const int64_t prerollSamples = std::llround(preroll * fs);
+    const int64_t totalSamples = std::llround(duration * fs);
+
+    std::vector<float>  output(totalSamples);
+    std::vector<Scalar> block(blockSize);
+
+    // Voice bank mode: a choir of voices spread around f0 and the default formants.
+    std::unique_ptr<WorkerPool> pool;
+    std::unique_ptr<VoiceBank>  voiceBank;
+
+    if (voiceCount > 0) {
+        pool = std::make_unique<WorkerPool>(program.get<int>("--threads"));
+        voiceBank = std::make_unique<VoiceBank>(voiceCount, *pool, fs, blockSize);
+
+        auto model = glottalFlow.genModel().lock();
+        model->updateParameterBounds(glottalFlow.parameters());
+        model->fitParameters(glottalFlow.parameters());
+        voiceBank->setGlottalFlowModel(*model);
+
+        const Scalar f0 = program.get<double>("--f0");
+        const auto&  F = VoiceBank::kDefaultF;
+        const auto&  B = VoiceBank::kDefaultB;
+
+        std::mt19937                           rng(1234);
+        std::uniform_real_distribution<Scalar> spread(-1, 1);
+
+        for (int v = 0; v < voiceCount; ++v) {
+            voiceBank->setPitch(v, f0 * std::exp2(spread(rng) / 2));
+            voiceBank->setGain(v, 1 / std::sqrt(Scalar(voiceCount)));
+            for (int k = 0; k < VoiceBank::kNumFormants; ++k) {
+                voiceBank->setFormant(v, k, F[k] * (1 + 0.1_f * spread(rng)), B[k]);
+            }
+        }
+
+        std::printf("Voice bank: %d voices on %d worker threads + caller\n", voiceCount,
+                    pool->threadCount());
+    }
+
+    if (RealtimeAudit::kEnabled) {
+        const bool abort = std::getenv("SOURCEMODEL_RT_AUDIT_ABORT") != nullptr;
+        RealtimeAudit::setAbortOnViolation(abort);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int64_t pos = -prerollSamples; pos < totalSamples; pos += blockSize) {
+        // Everything the app's audio callback does happens in here.
+        RealtimeAudit::Scope realtime;
+
+        if (voiceBank) {
+            voiceBank->process(block.data(), blockSize);
+        } else {
+            sourceGenerator.fillBuffer(intermediateBuffer);
+            if (doBypassFilter) {
+                std::copy(intermediateBuffer.begin(), intermediateBuffer.end(),
+                          block.begin());
+                for (auto& x : block) x *= 0.25_f;
+            } else {
+                formantGenerator.fillBuffer(block);
+            }
+        }
+        clock.advance(blockSize);
+
+        for (int i = 0; i < blockSize; ++i) {
+            if (pos + i >= 0 && pos + i < totalSamples) {
+                output[pos + i] = (float)block[i];
+            }
+        }
+    }
+
+    const auto   end = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(end - start).count();
+    const double renderedSamples = double(prerollSamples + totalSamples);
+
+    if (voiceBank) {
+        // The sum of many voices has no fixed level, normalize it to -1 dBFS.
+        float peak = 0;
+        for (const float x : output) peak = std::max(peak, std::abs(x));
+        if (peak > 0) {
+            for (float& x : output) x *= 0.89f / peak;
+        }
+    }
+
+    if (!writeOutput(outputPath, format, fs, output)) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::printf("Rendered %lld samples (%.3f s) in %.3f s\n",
+                (long long)(prerollSamples + totalSamples), renderedSamples / fs,
+                elapsed);
+    std::printf("Throughput: %.0f samples/s (%.1fx real time)\n",
+                renderedSamples / elapsed, renderedSamples / fs / elapsed);
+    if (!voiceBank) {
+        std::printf("Source cost: %.1f ns/sample (%dx oversampling)\n",
+                    sourceGenerator.costPerSample(), oversampling);
+
+        // Share of each block's duration spent in each stage.
+        const std::pair<const char*, LoadMeter*> stages[] = {
+            {"Source", &sourceGenerator.generatorLoad()},
+            {"Source gain reduction", &sourceGenerator.gainReductionLoad()},
+            {"Formants", &formantGenerator.generatorLoad()},
+            {"Formant gain reduction", &formantGenerator.gainReductionLoad()},
+        };
+        for (const auto& [name, meter] : stages) {
+            const auto statistics = meter->statistics();
+            std::printf("%s load: %.2f%% (peak %.2f%%)\n", name,
+                        100 * statistics.averageLoad, 100 * statistics.peakLoad);
+        }
+    } else {
+        std::printf("Voice throughput: %.0f voice-samples/s\n",
+                    renderedSamples * voiceCount / elapsed);
+    }
+    if (RealtimeAudit::kEnabled) {
+        const auto counts = RealtimeAudit::counts();
+        std::printf("Render loop: %llu allocations, %llu deallocations, %llu locks\n",
+                    (unsigned long long)counts.allocations,
+                    (unsigned long long)counts.deallocations,
+                    (unsigned long long)counts.locks);
+    }
+
+    return EXIT_SUCCESS;
+}